@@ -14,11 +14,15 @@ public:
     static void initializeLeaping();
     static void initialiseBishopAttacks();
     static void initialiseRookAttacks();
+    static void initialiseLines();
     static U64 getBishopAttacks(int square, U64 blockers);
     static U64 getRookAttacks(int square, U64 blockers);
     static U64 getKnightAttacks(int square);
     static U64 getKingAttacks(int square);
     static U64 getQueenAttacks(int square, U64 blockers);
+    static U64 getPawnAttacks(int colour, int square);
+    static U64 getBetween(int square1, int square2);
+    static U64 getLine(int square1, int square2);
     static void printBitboard(U64 bitboard, std::ofstream &outFile);
 
 private:
@@ -35,6 +39,11 @@ private:
     // Leaping piece variables
     static U64 KNIGHT_ATTACKS[64];
     static U64 KING_ATTACKS[64];
+    static U64 PAWN_ATTACKS[2][64];
+
+    // Squares strictly between two aligned squares, and the full line through them
+    static U64 BETWEEN[64][64];
+    static U64 LINE[64][64];
 
     // Bishop variables
     static U64 BISHOP_RAYS[4][64];
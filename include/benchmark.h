@@ -0,0 +1,39 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+#include <iostream>
+#include <string>
+#include "board.h"
+#include "minimaxEngine.h"
+
+// What one search of a benchmark position played and what it cost
+struct BenchmarkRun
+{
+    Move move;
+    int score;
+    long long nodes;
+    long long time;
+    long long allocations;
+    double cutoffRate;
+};
+
+class Benchmark
+{
+public:
+    static void runSearchBenchmark(int depth, int hashMegabytes, int threadCount, std::ostream &out);
+    static void runScalingBenchmark(int depth, std::ostream &out);
+    static void runFeatureBenchmark(int depth, std::ostream &out);
+    static void runTacticalCheck(int depth, std::ostream &out);
+    static bool runPerft(int depth, std::ostream &out);
+    static long long getAllocationCount();
+
+private:
+    static const std::string benchmarkPositions[];
+    static const int numberOfPositions;
+    static int countTacticsFound(int depth, const SearchParameters &params, std::ostream *out);
+    static long long perft(Board &board, int depth);
+    static BenchmarkRun searchPosition(const std::string &fen, int depth, const std::function<void(MinimaxEngine &)> &configure);
+};
+
+#endif
@@ -7,9 +7,21 @@
 #include <array>
 #include <chrono>
 #include "move.h"
+#include "zobrist.h"
 
 typedef uint64_t U64;
-typedef std::vector<Move> MoveVec;
+
+// The kinds of legal moves which can be generated.
+// Captures include en passant and all promotions, quiet moves include castling.
+enum GenerationType
+{
+    ALL_MOVES,
+    CAPTURES,
+    QUIET_MOVES
+};
+
+// Taken off the ordering score of a capture which loses material so it is searched after the quiet moves
+const int LOSING_CAPTURE_PENALTY = 100000;
 
 // Constants
 const U64 FILE_A = 0x0101010101010101ULL;
@@ -113,6 +125,24 @@ inline U64 south_west(U64 b)
     return ((b >> 9) & ~(FILE_H));
 }
 
+// Number of entries the state stack holds. When it fills up the oldest entries are dropped and only
+// the most recent STATE_STACK_KEPT are kept, enough for any search line and, since the fifty move
+// rule ends a game after a hundred plies without a capture or pawn move, for any repetition.
+const int MAX_GAME_PLY = 1024;
+const int STATE_STACK_KEPT = MAX_GAME_PLY / 2;
+
+// The parts of the position which a move cannot be undone without, pushed by applyMove and popped by undoMove
+struct StateInfo
+{
+    U64 hash;
+    int capturedPiece;
+    int enPassantSquare;
+    int halfMoveClock;
+    int pliesFromNullMove;
+    int checkStatus;
+    bool castlingRights[4];
+};
+
 class Board
 {
 public:
@@ -120,24 +150,48 @@ public:
     void resetBoard();
     void loadFromFEN(const std::string &fen);
 
-    std::vector<Move> generateLegalMoves();
+    void generateLegalMoves(MoveList &legalMoves) const;
+    void generateMoves(MoveList &moves, GenerationType type) const;
+    void generateCaptures(MoveList &captures) const;
+    bool hasAnyLegalMove() const;
+    bool isLegalMove(const Move &move) const;
     bool determineIfKingIsInCheck(int kingColour, int square) const;
+    bool isInCheck() const;
+    bool givesCheck(const Move &move) const;
+    U64 attackersTo(int square, U64 occupancy) const;
+    bool isSquareAttacked(int square, int attackingColour, U64 occupancy) const;
     void printAllInformation(std::ofstream &output) const;
 
     // Getters and Setters
     int getTurn() const { return turn; }
     const U64 *getBitboards() const { return bitboards; }
+    U64 getOccupancy(int colour) const { return occupancy[colour]; }
+    U64 getAllPieces() const { return occupancy[2]; }
     std::array<bool, 4> getCastlingRights() const { return {castlingRights[0], castlingRights[1], castlingRights[2], castlingRights[3]}; }
     int getEnPassantSquare() const { return enPassantSquare; }
     int getHalfMoveClock() const { return halfMoveClock; }
     int getFullMoveNumber() const { return fullMoveNumber; }
+    U64 getHash() const { return hash; }
+    U64 computeHash() const;
     void setBoard(int pieceToPlay);
     void setEnPassantSquare(int square);
     void setCastlingRights(int caslingRight, bool right);
 
-    // Function for making moves
+    // Function for making moves. The undo functions return false and leave the board as it is when
+    // the move is no longer on the state stack, which happens only to moves more than STATE_STACK_KEPT
+    // plies back after a long game has filled the stack.
     void applyMove(const Move &move);
-    void undoMove(const Move &move, const std::array<bool, 4> &prevCastlingRights, int prevEnPassantSquare, int prevHalfMoveClock);
+    bool undoMove(const Move &move);
+    void makeNullMove();
+    bool undoNullMove();
+    bool isRepetition() const;
+    bool isDraw() const;
+    bool hasNonPawnMaterial(int colour) const { return (occupancy[colour] & ~(bitboards[colour * 6] | bitboards[(colour * 6) + 5])) != 0; }
+    int getPieceIntAtPosition(int pos) const { return mailbox[pos]; }
+    int getCapturedPiece(const Move &move) const;
+    bool isCapture(const Move &move) const { return (move.getIsEnPassant() || (mailbox[move.getEndSquare()] != 12)); }
+    int scoreMove(const Move &move) const;
+    int see(const Move &move) const;
 
     int positionToIndex(const std::string &position);
     long long getTotalTimeSpentInPseudoFunction();
@@ -146,19 +200,67 @@ public:
 
 private:
     // Private member functions
-    std::vector<Move> generatePseudoLegalMoves() const;
-    void generatePawnPseudoLegalMoves(MoveVec &pawnMoves, U64 allPieces, U64 friendlyPieces, U64 enemyPieces) const;
+    void generateMovesFrom(MoveList &legalMoves, GenerationType type, U64 fromMask) const;
+    void generateMovesFrom(MoveList &legalMoves, GenerationType type, U64 fromMask, U64 checkers, U64 pinned) const;
+    U64 determineCheckers() const;
+    void generatePawnMoves(MoveList &pawnMoves, GenerationType type, U64 fromMask, U64 allPieces, U64 enemyPieces, U64 checkMask, U64 pinned, int kingPosition) const;
+    void addPawnMoves(MoveList &pawnMoves, U64 targets, int shift, U64 pinned, int kingPosition) const;
+    void generateCastlingMoves(MoveList &moves, U64 allPieces, int kingPosition) const;
+    void addPieceMoves(MoveList &moves, int startSquare, U64 targets, U64 enemyPieces) const;
+    bool isEnPassantLegal(int startSquare, int endSquare, U64 allPieces, int kingPosition) const;
+    U64 determinePinnedPieces(int kingPosition, U64 friendlyPieces, U64 enemyPieces) const;
+    U64 pinRay(int square, U64 pinned, int kingPosition) const;
     std::string getPieceAt(int pos) const;
-    int getPieceIntAtPosition(int pos) const;
+    void rebuildPieceLookups();
+    U64 castlingAndEnPassantHash() const;
+    StateInfo &pushState();
+    bool pieceLookupsMatchBitboards() const;
+
+    // Piece placement helpers which keep the bitboards, the occupancies and the mailbox in sync
+    void addPiece(int piece, int square)
+    {
+        U64 squareBitboard = 1ULL << square;
+        bitboards[piece] |= squareBitboard;
+        occupancy[piece / 6] |= squareBitboard;
+        occupancy[2] |= squareBitboard;
+        mailbox[square] = piece;
+        hash ^= Zobrist::getPieceKey(piece, square);
+    }
+    void removePiece(int piece, int square)
+    {
+        U64 squareBitboard = 1ULL << square;
+        bitboards[piece] &= ~squareBitboard;
+        occupancy[piece / 6] &= ~squareBitboard;
+        occupancy[2] &= ~squareBitboard;
+        mailbox[square] = 12;
+        hash ^= Zobrist::getPieceKey(piece, square);
+    }
+    void movePiece(int piece, int startSquare, int endSquare)
+    {
+        U64 moveBitboard = (1ULL << startSquare) | (1ULL << endSquare);
+        bitboards[piece] ^= moveBitboard;
+        occupancy[piece / 6] ^= moveBitboard;
+        occupancy[2] ^= moveBitboard;
+        mailbox[startSquare] = 12;
+        mailbox[endSquare] = piece;
+        hash ^= Zobrist::getPieceKey(piece, startSquare) ^ Zobrist::getPieceKey(piece, endSquare);
+    }
     int charToPieceIndex(char pieceChar) const;
 
     // Private member variables
     U64 bitboards[12];
+    uint8_t mailbox[64];  // Piece index on each square, 12 for an empty square
+    U64 occupancy[3];     // White pieces, black pieces and all pieces
+    U64 hash;             // Zobrist key of the position
     int turn;
     bool castlingRights[4];
     int enPassantSquare;
     int halfMoveClock;
+    int pliesFromNullMove; // Plies since the last null move, a repetition is never looked for across one
+    mutable int checkStatus; // Whether the side to move is in check, -1 until it is first asked for
     int fullMoveNumber;
+    StateInfo stateStack[MAX_GAME_PLY];
+    int stateCount;       // Number of moves on the state stack
     static std::chrono::microseconds totalTimeSpentInPseudo;
     static std::chrono::microseconds totalTimeSpentInLegal;
     static std::chrono::microseconds totalTimeSpentInOther;
@@ -2,6 +2,7 @@
 #define EVALUATION_H
 
 #include "board.h"
+#include "score.h"
 
 struct EvaluationParameters
 {
@@ -18,13 +19,12 @@ class Evaluation
 {
 public:
     Evaluation(const EvaluationParameters &params);
-    double evaluateBoard(Board &board) const;
+    int evaluateBoard(Board &board) const;
 
 private:
-    double materialEvaluation(const Board &board) const;
+    int materialEvaluation(const Board &board) const;
     int determineNumberOfSpecificPieces(int index, const U64 *bitboards) const;
     EvaluationParameters evalParams;
-    static const double pieceValues[12];
 };
 
 #endif
\ No newline at end of file
@@ -3,21 +3,142 @@
 
 #include "move.h"
 #include "board.h"
+#include "transpositionTable.h"
+#include "timeManager.h"
+#include "searchThread.h"
+#include "score.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
 
-const double pieceValues[12] = {1, 3, 3, 5, 9, 0, -1, -3, -3, -5, -9, 0};
+// Deepest iteration the search will start
+const int MAX_SEARCH_DEPTH = 64;
 
+// Half width of the first aspiration window around the previous iteration's score, and the first
+// depth which uses one. The window grows by half again each time the search falls outside it.
+const int ASPIRATION_WINDOW = 25;
+const int ASPIRATION_MIN_DEPTH = 4;
+
+// Null move pruning is tried from this depth, with a reduction of NULL_MOVE_REDUCTION plus one ply for every six of depth
+const int NULL_MOVE_MIN_DEPTH = 3;
+const int NULL_MOVE_REDUCTION = 3;
+
+// Late quiet moves are reduced from this depth, after this many moves have been searched at full depth
+const int LMR_MIN_DEPTH = 3;
+const int LMR_FULL_DEPTH_MOVES = 3;
+
+// Margin added to a capture's gain before the quiescence search decides it cannot raise the score enough
+const int DELTA_MARGIN = 200;
+
+// Deepest remaining depth at which each kind of pruning near the leaves is tried
+const int REVERSE_FUTILITY_MAX_DEPTH = 6;
+const int FUTILITY_MAX_DEPTH = 3;
+const int RAZORING_MAX_DEPTH = 3;
+
+// Singular extensions are tried from this depth, against a stored score at most this far short of
+// the node's depth, and the other moves have to fall short of the stored score by the margin per ply
+const int SINGULAR_MIN_DEPTH = 6;
+const int SINGULAR_TT_DEPTH_MARGIN = 3;
+const int SINGULAR_MARGIN = 2;
+
+// Switches and margins for the pruning near the leaves, the margins are in centipawns per ply of
+// remaining depth, and switches for the extensions of forcing moves. Each kind can be turned off
+// to measure its effect on the benchmark positions. Razoring is off by default, it drops to the
+// quiescence search which cannot see quiet mates and saved only a few percent of the nodes.
+struct SearchParameters
+{
+    bool reverseFutilityPruning;
+    bool futilityPruning;
+    bool razoring;
+    int reverseFutilityMargin;
+    int futilityMargin;
+    int razoringMargin;
+    bool checkExtensions;
+    bool recaptureExtensions;
+    bool singularExtensions;
+    SearchParameters(
+        bool reverseFutility = true,
+        bool futility = true,
+        bool razor = false,
+        int reverseFutilityPerPly = 100,
+        int futilityPerPly = 150,
+        int razoringPerPly = 300,
+        bool checks = true,
+        bool recaptures = true,
+        bool singular = true) : reverseFutilityPruning(reverseFutility), futilityPruning(futility), razoring(razor),
+                                reverseFutilityMargin(reverseFutilityPerPly), futilityMargin(futilityPerPly), razoringMargin(razoringPerPly),
+                                checkExtensions(checks), recaptureExtensions(recaptures), singularExtensions(singular)
+    {
+    }
+};
+
+// Runs the search on a number of threads which share one transposition table.
+// The calling thread searches as the main thread and decides when the search stops,
+// except when pondering where a background thread takes its place.
 class MinimaxEngine
 {
 public:
     MinimaxEngine(int depth = 5);
+    ~MinimaxEngine();
+    MinimaxEngine(const MinimaxEngine &) = delete;
+    MinimaxEngine &operator=(const MinimaxEngine &) = delete;
     Move findBestMove(Board &board, int depth);
+    Move findBestMove(Board &board, const SearchLimits &limits);
+
+    // Pondering searches the position after the opponent's expected reply while the opponent thinks.
+    // On a ponderhit the search carries on under the clock and finishPondering gives its move,
+    // on a miss stopPondering throws the search away but the tables it filled are kept.
+    Move getPonderMove() const;
+    bool startPondering(const Board &board, const SearchLimits &limits);
+    void ponderHit() { timeManager.ponderHit(); }
+    Move finishPondering();
+    void stopPondering();
+    long long getNodeCount() const;
+    double getFirstMoveCutoffRate() const;
+    int getCompletedDepth() const { return bestThread->getCompletedDepth(); }
+    int getBestScore() const { return bestThread->getBestScore(); }
+    std::vector<Move> getPrincipalVariation() const { return bestThread->getPrincipalVariation(); }
+    std::vector<SearchLine> getLines() const { return bestThread->getLines(); }
+
+    // The options are read by the search threads, so setting one first stops any ponder search
+    void setMultiPV(int count);
+    int getMultiPV() const { return multiPV; }
+    void setSearchParameters(const SearchParameters &params);
+    const SearchParameters &getSearchParameters() const { return searchParams; }
+    void setHashSize(int megabytes);
+    void clearHash();
+    void setThreadCount(int count);
+    int getThreadCount() const { return (int)threads.size(); }
+
+    // Shared with the search threads
+    TranspositionTable &getTranspositionTable() { return transpositionTable; }
+    bool isStopped() const { return stopped.load(std::memory_order_relaxed); }
+    void stop() { stopped.store(true, std::memory_order_relaxed); }
+    bool limitsReached() const;
+    bool softLimitReached() const { return timeManager.softLimitReached(); }
 
 private:
-    double minimax(Board &board, int depth, bool maximizingPlayer, double alpha, double beta);
-    double evaluateBoard(Board &board);
-    double evaluateMaterial(const Board &board);
-    int determineNumberOfSpecificPieces(int index, const U64 *bitboards);
+    bool prepareSearch(const Board &board, const SearchLimits &limits);
+    Move runSearch();
+    const SearchThread *selectBestThread() const;
+
     int engineDepth;
+    int searchDepth;
+    int multiPV;
+    SearchParameters searchParams;
+    long long nodeLimit;
+    std::atomic<bool> stopped;
+    TimeManager timeManager;
+    TranspositionTable transpositionTable;
+    std::vector<std::unique_ptr<SearchThread>> threads;
+    const SearchThread *bestThread;
+
+    // The position being pondered and the background thread searching it
+    Board ponderBoard;
+    std::thread ponderThread;
+    Move ponderResult;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -2,33 +2,84 @@
 #define MOVE_H
 
 #include <string>
+#include <cstdint>
 
+// Move flags, stored in the top two bits of the packed move
+enum MoveFlag
+{
+    NORMAL_MOVE = 0,
+    PROMOTION = 1,
+    EN_PASSANT = 2,
+    CASTLING = 3
+};
+
+// A move is packed into 16 bits:
+// bits 0-5 start square, bits 6-11 end square,
+// bits 12-13 promotion piece (0 = knight, 1 = bishop, 2 = rook, 3 = queen),
+// bits 14-15 move flag.
+// The moved and captured pieces are not stored, they are read from the board when needed.
 class Move
 {
 public:
-    Move();
-    Move(int startSquare, int endSquare, int movedPiece, int capturedPiece, int promotionPiece = 12, bool isEnPassant = false, bool isCastling = false, double score = 0.0);
-
-    int getStartSquare() const { return startSquare; }
-    int getEndSquare() const { return endSquare; }
-    int getMovedPiece() const { return movedPiece; }
-    int getCapturedPiece() const { return capturedPiece; }
-    int getPromotionPiece() const { return promotionPiece; }
-    bool getIsEnPassant() const { return isEnPassant; }
-    bool getIsCastling() const { return isCastling; }
-    double getScore() const { return score; }
+    // Left trivial so a MoveList does not initialise all of its slots, Move() gives the null move
+    Move() = default;
+    Move(int startSquare, int endSquare, int flag = NORMAL_MOVE, int promotionPiece = 12);
+    static Move fromData(uint16_t data)
+    {
+        Move move;
+        move.data = data;
+        return move;
+    }
+
+    int getStartSquare() const { return data & 0x3F; }
+    int getEndSquare() const { return (data >> 6) & 0x3F; }
+    int getFlag() const { return (data >> 14) & 0x3; }
+    int getPromotionPiece(int colour) const;
+    bool getIsPromotion() const { return getFlag() == PROMOTION; }
+    bool getIsEnPassant() const { return getFlag() == EN_PASSANT; }
+    bool getIsCastling() const { return getFlag() == CASTLING; }
+    bool isNull() const { return data == 0; }
+    uint16_t getData() const { return data; }
     std::string printMove() const;
-    void setMoveScore();
+
+    bool operator==(const Move &other) const { return data == other.data; }
+    bool operator!=(const Move &other) const { return data != other.data; }
+
+private:
+    uint16_t data;
+};
+
+static_assert(sizeof(Move) == 2, "Move should be packed into 16 bits");
+
+const int MAX_MOVES = 256;
+
+// Fixed capacity list of moves with a parallel array of ordering scores.
+// It is meant to live on the stack so that move generation never allocates.
+class MoveList
+{
+public:
+    MoveList() : count(0) {}
+
+    void addMove(const Move &move) { moves[count++] = move; }
+    void addMove(const Move &move, int score)
+    {
+        moves[count] = move;
+        scores[count++] = score;
+    }
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Move &operator[](int i) const { return moves[i]; }
+    int getScore(int i) const { return scores[i]; }
+    void setScore(int i, int score) { scores[i] = score; }
+    void sortByScore();
+    void selectBest(int start);
+    void moveToFront(int index, int front = 0);
 
 private:
-    int startSquare;
-    int endSquare;
-    int movedPiece;
-    int capturedPiece;
-    int promotionPiece;
-    bool isEnPassant;
-    bool isCastling;
-    double score;
+    Move moves[MAX_MOVES];
+    int scores[MAX_MOVES];
+    int count;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,46 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "board.h"
+#include "move.h"
+
+// Butterfly history, a score for each side, start square and end square of how often
+// the quiet move has caused a beta cutoff. Scores are kept within +-HISTORY_MAX.
+typedef int ButterflyHistory[2][64][64];
+const int HISTORY_MAX = 16384;
+
+// The stages of the move picker, the moves of a stage are only generated once it is reached
+enum PickerStage
+{
+    TT_MOVE_STAGE,
+    GENERATE_CAPTURES_STAGE,
+    GOOD_CAPTURES_STAGE,
+    KILLER_MOVES_STAGE,
+    GENERATE_QUIETS_STAGE,
+    QUIET_MOVES_STAGE,
+    BAD_CAPTURES_STAGE,
+    FINISHED_STAGE
+};
+
+class MovePicker
+{
+public:
+    MovePicker(const Board &board, const Move &ttMove, const Move &killer1, const Move &killer2, const ButterflyHistory *history = nullptr);
+    Move nextMove();
+
+private:
+    bool isAlreadyPicked(const Move &move) const;
+
+    const Board &board;
+    const ButterflyHistory *history;
+    Move ttMove;
+    Move killers[2];
+    int stage;
+    int killerIndex;
+    MoveList captures;
+    int captureIndex;
+    MoveList quietMoves;
+    int quietIndex;
+};
+
+#endif
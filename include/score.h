@@ -0,0 +1,36 @@
+#ifndef SCORE_H
+#define SCORE_H
+
+// Scores are integers in centipawns. A mate is scored as MATE_SCORE less the number of plies
+// from the root to the mate, so a faster mate always scores higher than a slower one.
+
+// Deepest ply the search can reach
+const int MAX_PLY = 128;
+
+const int DRAW_SCORE = 0;
+const int MATE_SCORE = 32000;
+const int INFINITE_SCORE = 32001;
+
+// Any score at least this large in magnitude is a mate
+const int MATE_BOUND = MATE_SCORE - MAX_PLY;
+
+// Score of the side to move when it is mated at this ply, or when it mates at this ply
+inline int matedIn(int ply)
+{
+    return -MATE_SCORE + ply;
+}
+
+inline int mateIn(int ply)
+{
+    return MATE_SCORE - ply;
+}
+
+inline bool isMateScore(int score)
+{
+    return (score >= MATE_BOUND) || (score <= -MATE_BOUND);
+}
+
+// Value of each piece indexed like the bitboards, positive for white and negative for black
+const int pieceValues[12] = {100, 300, 300, 500, 900, 0, -100, -300, -300, -500, -900, 0};
+
+#endif
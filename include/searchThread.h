@@ -0,0 +1,116 @@
+#ifndef SEARCH_THREAD_H
+#define SEARCH_THREAD_H
+
+#include <atomic>
+#include <vector>
+#include "board.h"
+#include "move.h"
+#include "score.h"
+#include "movePicker.h"
+
+class MinimaxEngine;
+
+// Most lines a multi PV search can report
+const int MAX_MULTI_PV = 16;
+
+// One of the best lines from the root, with its score and the depth it was searched to
+struct SearchLine
+{
+    int score;
+    int depth;
+    std::vector<Move> principalVariation;
+};
+
+// One searcher of the Lazy SMP search. Every thread searches the same root position on its own
+// copy of the board with its own tables, and the threads only share the engine's transposition
+// table, so they help each other through the entries the others leave behind.
+class SearchThread
+{
+public:
+    SearchThread(int id, MinimaxEngine &engine);
+    static void initialiseReductions();
+    void setPosition(const Board &rootBoard, const MoveList &legalMoves);
+    void iterativeDeepening(int maxDepth);
+
+    int getId() const { return id; }
+    Move getBestMove() const { return bestMove; }
+    int getBestScore() const { return bestScore; }
+    int getCompletedDepth() const { return completedDepth; }
+    long long getNodeCount() const { return nodeCount.load(std::memory_order_relaxed); }
+    long long getCutoffCount() const { return cutoffCount; }
+    long long getFirstMoveCutoffCount() const { return firstMoveCutoffCount; }
+    std::vector<Move> getPrincipalVariation() const;
+    std::vector<SearchLine> getLines() const;
+
+private:
+    void aspirationSearch(int depth);
+    void searchRoot(int depth, int alpha, int beta);
+    void keepSearchedLine(int score);
+    int negamax(int depth, int ply, int alpha, int beta);
+    int searchChild(int depth, int ply, int alpha, int beta, bool firstMove, int reduction);
+    int quiescence(int ply, int alpha, int beta);
+    void updatePrincipalVariation(int ply, const Move &move);
+    void placeRootMove(const Move &move, int position);
+    void countNode();
+    void updateQuietHeuristics(const Move &move, int depth, int ply, const Move *quietsSearched, int quietCount);
+    void updateHistory(const Move &move, int bonus);
+    void storeResult(const Move &move, int value, int depth, int ply, int alpha, int beta);
+    int staticEvaluation() const;
+    int evaluateMaterial() const;
+    int determineNumberOfSpecificPieces(int index, const U64 *bitboards) const;
+
+    int id;
+    MinimaxEngine &engine;
+    Board board;
+    MoveList rootMoves;
+
+    // Only this thread writes the count, it is atomic so the main thread can add up the nodes while searching
+    std::atomic<long long> nodeCount;
+    int completedDepth;
+    int bestScore;
+
+    // Beta cutoffs in the main search and how many of them came from the first move searched,
+    // the share of first move cutoffs measures how good the move ordering is
+    long long cutoffCount;
+    long long firstMoveCutoffCount;
+    Move bestMove;
+
+    // Move ordering heuristics, two killer moves for each ply and the butterfly history
+    Move killers[MAX_PLY][2];
+    ButterflyHistory history;
+
+    // Whether the move made at each ply of the current line is a null move, two are never played in a row
+    bool nullMoveAtPly[MAX_PLY];
+
+    // Square captured on by the move made at each ply of the current line, -1 for a move which captured nothing
+    int captureSquareAtPly[MAX_PLY];
+
+    // Move left out at each ply while a singular extension search checks the other moves
+    Move excludedMove[MAX_PLY];
+
+    // Depth of the current iteration, extensions stop once a line is twice as long
+    int rootDepth;
+
+    // Late move reductions by depth and by the number of moves searched
+    static int REDUCTIONS[64][64];
+
+    // Triangular table of the best line found from each ply
+    Move pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+
+    // The best lines from the root as of the last completed iteration, each with a different first move,
+    // and the lines kept so far by the root search of the current iteration
+    struct RootLine
+    {
+        int score;
+        int depth;
+        int length;
+        Move moves[MAX_PLY];
+    };
+    RootLine lines[MAX_MULTI_PV];
+    RootLine searchedLines[MAX_MULTI_PV];
+    int lineCount;
+    int searchedLineCount;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TIME_MANAGER_H
+#define TIME_MANAGER_H
+
+#include <atomic>
+#include <chrono>
+
+// What the search has been told it may use, a value of 0 means there is no such limit.
+// Times are in milliseconds.
+struct SearchLimits
+{
+    long long whiteTime = 0;
+    long long blackTime = 0;
+    long long whiteIncrement = 0;
+    long long blackIncrement = 0;
+    int movesToGo = 0;
+    long long moveTime = 0;
+    long long nodes = 0;
+    int depth = 0;
+
+    // Searching on the opponent's time, the clock limits only apply once the expected move is played
+    bool ponder = false;
+};
+
+// Turns the clock state into two budgets for a move. No new iteration is started after
+// the soft limit has passed and the search is stopped outright at the hard limit.
+// While pondering neither limit is reached, a ponderhit then switches them on with the
+// time already searched counting against them.
+class TimeManager
+{
+public:
+    void start(const SearchLimits &limits, int colour);
+    void ponderHit() { pondering.store(false, std::memory_order_relaxed); }
+    long long getElapsedTime() const;
+    bool isTimeLimited() const { return timeLimited; }
+    bool isPondering() const { return pondering.load(std::memory_order_relaxed); }
+    bool softLimitReached() const { return (timeLimited == true) && (isPondering() == false) && (getElapsedTime() >= softLimit); }
+    bool hardLimitReached() const { return (timeLimited == true) && (isPondering() == false) && (getElapsedTime() >= hardLimit); }
+
+private:
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<bool> pondering{false};
+    bool timeLimited;
+    long long softLimit;
+    long long hardLimit;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include "move.h"
+
+typedef uint64_t U64;
+
+// What a stored score says about the true score of the position
+enum BoundType
+{
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,
+    BOUND_LOWER = 2,
+    BOUND_EXACT = 3
+};
+
+// The unpacked contents of an entry, filled in by a successful probe
+struct TTEntryData
+{
+    Move move;
+    int score;
+    int depth;
+    int bound;
+};
+
+// The key is stored XORed with the data, so an entry torn by two threads writing it at
+// the same time fails the key check instead of handing back another position's data
+struct TTEntry
+{
+    std::atomic<U64> keyXorData;
+    std::atomic<U64> data;
+};
+
+const int ENTRIES_PER_BUCKET = 4;
+
+// A bucket fills exactly one cache line so a probe only ever touches one line
+struct alignas(64) TTBucket
+{
+    TTEntry entries[ENTRIES_PER_BUCKET];
+};
+
+static_assert(sizeof(TTBucket) == 64, "A bucket should fill one cache line");
+
+// Hash table of search results keyed by the Zobrist key of the position.
+// It can be shared by several searching threads without locking.
+class TranspositionTable
+{
+public:
+    TranspositionTable(size_t megabytes = 16);
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch() { age = (age + 1) & 0x3F; }
+    bool probe(U64 key, TTEntryData &entry) const;
+    void store(U64 key, const Move &move, int score, int depth, int bound);
+    void prefetch(U64 key) const { __builtin_prefetch(&buckets[key & bucketMask]); }
+    size_t getSizeInMegabytes() const { return ((bucketMask + 1) * sizeof(TTBucket)) >> 20; }
+
+private:
+    // Data layout: bits 0-15 move, 16-31 score, 32-39 depth, 40-41 bound, 42-47 age
+    static U64 packData(const Move &move, int score, int depth, int bound, int age);
+    static int dataDepth(U64 data) { return (data >> 32) & 0xFF; }
+    static int dataAge(U64 data) { return (data >> 42) & 0x3F; }
+
+    std::unique_ptr<TTBucket[]> buckets;
+    U64 bucketMask;
+    int age;
+};
+
+#endif
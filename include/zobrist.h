@@ -0,0 +1,25 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+
+typedef uint64_t U64;
+
+// Random keys used to hash positions, a position's key is the XOR of the keys of its features
+class Zobrist
+{
+public:
+    static void initialiseKeys();
+    static U64 getPieceKey(int piece, int square) { return PIECE_KEYS[piece][square]; }
+    static U64 getSideKey() { return SIDE_KEY; }
+    static U64 getCastlingKey(int castlingRight) { return CASTLING_KEYS[castlingRight]; }
+    static U64 getEnPassantKey(int file) { return EN_PASSANT_KEYS[file]; }
+
+private:
+    static U64 PIECE_KEYS[12][64];
+    static U64 SIDE_KEY;
+    static U64 CASTLING_KEYS[4];
+    static U64 EN_PASSANT_KEYS[8];
+};
+
+#endif
@@ -8,6 +8,8 @@
 #include "attackTables.h"
 #include "move.h"
 #include "minimaxEngine.h"
+#include "benchmark.h"
+#include "zobrist.h"
 
 typedef U64 uint64_t;
 
@@ -92,6 +94,50 @@ int main(int argc, char *argv[])
     attackTables::initializeLeaping();
     attackTables::initialiseBishopAttacks();
     attackTables::initialiseRookAttacks();
+    attackTables::initialiseLines();
+    Zobrist::initialiseKeys();
+    SearchThread::initialiseReductions();
+
+    // Running "bench [depth] [hash size in MB] [threads]" searches a fixed set of positions and reports the statistics
+    if ((argc > 1) && (string(argv[1]) == "bench"))
+    {
+        int depth = (argc > 2) ? stoi(argv[2]) : 4;
+        int hashMegabytes = (argc > 3) ? stoi(argv[3]) : 16;
+        int threadCount = (argc > 4) ? stoi(argv[4]) : 1;
+        Benchmark::runSearchBenchmark(depth, hashMegabytes, threadCount, cout);
+        return 0;
+    }
+
+    // Running "scaling [depth]" reports how the search speeds up with more threads
+    if ((argc > 1) && (string(argv[1]) == "scaling"))
+    {
+        int depth = (argc > 2) ? stoi(argv[2]) : 6;
+        Benchmark::runScalingBenchmark(depth, cout);
+        return 0;
+    }
+
+    // Running "features [depth]" reports what each kind of pruning and extension changes in the search
+    if ((argc > 1) && (string(argv[1]) == "features"))
+    {
+        int depth = (argc > 2) ? stoi(argv[2]) : 6;
+        Benchmark::runFeatureBenchmark(depth, cout);
+        return 0;
+    }
+
+    // Running "perft [depth]" checks the move generator against known leaf counts, failing if any differ
+    if ((argc > 1) && (string(argv[1]) == "perft"))
+    {
+        int depth = (argc > 2) ? stoi(argv[2]) : 4;
+        return (Benchmark::runPerft(depth, cout) == true) ? 0 : 1;
+    }
+
+    // Running "tactics [depth]" checks that the search still finds the winning move in positions pruning has missed before
+    if ((argc > 1) && (string(argv[1]) == "tactics"))
+    {
+        int depth = (argc > 2) ? stoi(argv[2]) : 6;
+        Benchmark::runTacticalCheck(depth, cout);
+        return 0;
+    }
 
     // Setting up the board
     std::string fen = "5rk1/1p3pp1/1p1Rb2p/1B2p3/8/4P3/rPP2PPP/5RK1 w - - 0 20";
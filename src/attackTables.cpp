@@ -10,6 +10,11 @@ typedef uint64_t U64;
 // Leaping variables
 U64 attackTables::KNIGHT_ATTACKS[64];
 U64 attackTables::KING_ATTACKS[64];
+U64 attackTables::PAWN_ATTACKS[2][64];
+
+// Line variables
+U64 attackTables::BETWEEN[64][64];
+U64 attackTables::LINE[64][64];
 
 // Bishop variables
 U64 attackTables::BISHOP_RAYS[4][64];
@@ -57,6 +62,16 @@ void attackTables::initializeLeaping()
         allAttacks = leftAttacks | rightAttacks | verticalAttacks;
         KING_ATTACKS[i] = allAttacks;
     }
+
+    U64 pawn;
+
+    for (int i = 0; i < 64; i++)
+    {
+        pawn = 0ULL;
+        set_bit(pawn, i);
+        PAWN_ATTACKS[0][i] = north_west(pawn) | north_east(pawn);
+        PAWN_ATTACKS[1][i] = south_west(pawn) | south_east(pawn);
+    }
 }
 
 U64 attackTables::getKnightAttacks(int square)
@@ -69,6 +84,54 @@ U64 attackTables::getKingAttacks(int square)
     return KING_ATTACKS[square];
 }
 
+U64 attackTables::getPawnAttacks(int colour, int square)
+{
+    return PAWN_ATTACKS[colour][square];
+}
+
+// Must be called after the bishop and rook attacks have been initialised
+void attackTables::initialiseLines()
+{
+    for (int square1 = 0; square1 < 64; square1++)
+    {
+        for (int square2 = 0; square2 < 64; square2++)
+        {
+            BETWEEN[square1][square2] = 0ULL;
+            LINE[square1][square2] = 0ULL;
+            if (square1 == square2)
+            {
+                continue;
+            }
+
+            U64 square2Bitboard = 0ULL;
+            set_bit(square2Bitboard, square2);
+            U64 square1Bitboard = 0ULL;
+            set_bit(square1Bitboard, square1);
+
+            if (getBishopAttacks(square1, 0ULL) & square2Bitboard)
+            {
+                BETWEEN[square1][square2] = getBishopAttacks(square1, square2Bitboard) & getBishopAttacks(square2, square1Bitboard);
+                LINE[square1][square2] = (getBishopAttacks(square1, 0ULL) & getBishopAttacks(square2, 0ULL)) | square1Bitboard | square2Bitboard;
+            }
+            else if (getRookAttacks(square1, 0ULL) & square2Bitboard)
+            {
+                BETWEEN[square1][square2] = getRookAttacks(square1, square2Bitboard) & getRookAttacks(square2, square1Bitboard);
+                LINE[square1][square2] = (getRookAttacks(square1, 0ULL) & getRookAttacks(square2, 0ULL)) | square1Bitboard | square2Bitboard;
+            }
+        }
+    }
+}
+
+U64 attackTables::getBetween(int square1, int square2)
+{
+    return BETWEEN[square1][square2];
+}
+
+U64 attackTables::getLine(int square1, int square2)
+{
+    return LINE[square1][square2];
+}
+
 void attackTables::initialiseBishopAttacks()
 {
     initialiseBishopRayAndMask();
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include "benchmark.h"
+#include "minimaxEngine.h"
+
+// Every heap allocation in the program goes through these operators so the
+// benchmark can report how many allocations the search makes per node. Helper and ponder
+// threads allocate alongside the main thread, so the count is atomic.
+static std::atomic<long long> allocationCount(0);
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void *pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+const std::string Benchmark::benchmarkPositions[] = {
+    "5rk1/1p3pp1/1p1Rb2p/1B2p3/8/4P3/rPP2PPP/5RK1 w - - 0 20",
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"};
+
+const int Benchmark::numberOfPositions = sizeof(benchmarkPositions) / sizeof(benchmarkPositions[0]);
+
+// Positions with one winning move which pruning has been seen to miss, with the squares of that move
+struct TacticalPosition
+{
+    std::string fen;
+    int startSquare;
+    int endSquare;
+};
+
+static const TacticalPosition tacticalPositions[] = {
+    // Ra6 mates in two with a quiet pawn move after bxa6, razoring at 300 centipawns per ply lost it
+    {"kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1", 0, 40}};
+
+static const int numberOfTacticalPositions = sizeof(tacticalPositions) / sizeof(tacticalPositions[0]);
+
+// Positions with the number of leaf nodes at each depth from 1, a zero where the count is not known
+const int MAX_PERFT_DEPTH = 6;
+
+struct PerftPosition
+{
+    std::string fen;
+    long long counts[MAX_PERFT_DEPTH];
+};
+
+static const PerftPosition perftPositions[] = {
+    {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", {48, 2039, 97862, 4085603, 193690690, 8031647685}},
+    {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", {14, 191, 2812, 43238, 674624, 11030083}},
+    {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", {6, 264, 9467, 422333, 15833292, 706045033}},
+    {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379, 2103487, 89941194, 0}},
+    // The position main plays from, counted with a separate mailbox move generator
+    {"5rk1/1p3pp1/1p1Rb2p/1B2p3/8/4P3/rPP2PPP/5RK1 w - - 0 20", {35, 1001, 34501, 1005019, 34046164, 0}}};
+
+static const int numberOfPerftPositions = sizeof(perftPositions) / sizeof(perftPositions[0]);
+
+long long Benchmark::getAllocationCount()
+{
+    return allocationCount.load();
+}
+
+// Searches the position to the depth with a new engine which configure sets up first. Only the
+// search itself is timed and has its allocations counted.
+BenchmarkRun Benchmark::searchPosition(const std::string &fen, int depth, const std::function<void(MinimaxEngine &)> &configure)
+{
+    Board board = Board();
+    board.loadFromFEN(fen);
+    MinimaxEngine engine = MinimaxEngine(depth);
+    configure(engine);
+
+    BenchmarkRun run;
+    long long allocationsBefore = allocationCount.load();
+    auto start = std::chrono::high_resolution_clock::now();
+    run.move = engine.findBestMove(board, depth);
+    auto stop = std::chrono::high_resolution_clock::now();
+    run.allocations = allocationCount.load() - allocationsBefore;
+    run.time = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count();
+    run.score = engine.getBestScore();
+    run.nodes = engine.getNodeCount();
+    run.cutoffRate = engine.getFirstMoveCutoffRate();
+    return run;
+}
+
+void Benchmark::runSearchBenchmark(int depth, int hashMegabytes, int threadCount, std::ostream &out)
+{
+    long long totalNodes = 0;
+    long long totalAllocations = 0;
+    long long totalTime = 0;
+    double totalCutoffRate = 0;
+
+    for (int i = 0; i < numberOfPositions; i++)
+    {
+        BenchmarkRun run = searchPosition(benchmarkPositions[i], depth, [&](MinimaxEngine &engine) {
+            engine.setHashSize(hashMegabytes);
+            engine.setThreadCount(threadCount);
+        });
+        long long allocations = run.allocations;
+        long long time = run.time;
+        long long nodes = run.nodes;
+        double cutoffRate = run.cutoffRate;
+
+        out << "Position " << (i + 1) << ": " << nodes << " nodes, "
+            << allocations << " allocations ("
+            << (nodes > 0 ? (double)allocations / nodes : 0.0) << " per node), "
+            << time << " ms, "
+            << (cutoffRate * 100) << "% first move cutoffs\n";
+
+        totalNodes += nodes;
+        totalCutoffRate += cutoffRate;
+        totalAllocations += allocations;
+        totalTime += time;
+    }
+
+    out << "Total: " << totalNodes << " nodes, "
+        << totalAllocations << " allocations ("
+        << (totalNodes > 0 ? (double)totalAllocations / totalNodes : 0.0) << " per node), "
+        << totalTime << " ms, "
+        << (totalTime > 0 ? (totalNodes * 1000 / totalTime) : 0) << " nodes per second, "
+        << (totalCutoffRate * 100 / numberOfPositions) << "% first move cutoffs on average\n";
+}
+
+// Searches every position to the same depth with 1, 2, 4, 8 and 16 threads and reports the
+// time taken to reach the depth and the nodes per second, both relative to one thread
+void Benchmark::runScalingBenchmark(int depth, std::ostream &out)
+{
+    const int threadCounts[] = {1, 2, 4, 8, 16};
+    long long singleThreadTime = 0;
+    long long singleThreadNps = 0;
+
+    for (int threadCount : threadCounts)
+    {
+        long long totalNodes = 0;
+        long long totalTime = 0;
+
+        for (int i = 0; i < numberOfPositions; i++)
+        {
+            BenchmarkRun run = searchPosition(benchmarkPositions[i], depth, [&](MinimaxEngine &engine) { engine.setThreadCount(threadCount); });
+            totalTime += run.time;
+            totalNodes += run.nodes;
+        }
+
+        long long nps = (totalTime > 0) ? (totalNodes * 1000 / totalTime) : 0;
+        if (threadCount == 1)
+        {
+            singleThreadTime = totalTime;
+            singleThreadNps = nps;
+        }
+
+        out << threadCount << " threads: time to depth " << depth << " " << totalTime << " ms ("
+            << (totalTime > 0 ? (double)singleThreadTime / totalTime : 0.0) << "x), "
+            << totalNodes << " nodes, " << nps << " nodes per second ("
+            << (singleThreadNps > 0 ? (double)nps / singleThreadNps : 0.0) << "x)\n";
+    }
+}
+
+// Searches every position to the same depth with the default search, then with each kind of pruning
+// near the leaves and each extension turned off in turn, and with all of the pruning or all of the
+// extensions off, and reports the nodes and time of each
+void Benchmark::runFeatureBenchmark(int depth, std::ostream &out)
+{
+    const int settingCount = 9;
+    const std::string names[settingCount] = {"default", "no reverse futility pruning", "no futility pruning", "razoring", "no pruning",
+                                             "no check extensions", "no recapture extensions", "no singular extensions", "no extensions"};
+    SearchParameters settings[settingCount];
+    settings[1].reverseFutilityPruning = false;
+    settings[2].futilityPruning = false;
+    settings[3].razoring = true;
+    settings[4].reverseFutilityPruning = settings[4].futilityPruning = false;
+    settings[5].checkExtensions = false;
+    settings[6].recaptureExtensions = false;
+    settings[7].singularExtensions = false;
+    settings[8].checkExtensions = settings[8].recaptureExtensions = settings[8].singularExtensions = false;
+    long long defaultNodes = 0;
+
+    for (int setting = 0; setting < settingCount; setting++)
+    {
+        long long totalNodes = 0;
+        long long totalTime = 0;
+
+        for (int i = 0; i < numberOfPositions; i++)
+        {
+            BenchmarkRun run = searchPosition(benchmarkPositions[i], depth, [&](MinimaxEngine &engine) { engine.setSearchParameters(settings[setting]); });
+            totalTime += run.time;
+            totalNodes += run.nodes;
+        }
+
+        if (setting == 0)
+        {
+            defaultNodes = totalNodes;
+        }
+
+        out << names[setting] << ": " << totalNodes << " nodes ("
+            << (defaultNodes > 0 ? (double)totalNodes / defaultNodes : 0.0) << "x), "
+            << totalTime << " ms, " << countTacticsFound(depth, settings[setting], nullptr) << "/"
+            << numberOfTacticalPositions << " tactics found\n";
+    }
+}
+
+// Counts the legal move sequences of the given length, the moves at the last ply are counted without
+// being made. The moves are generated unordered since the order does not change the count.
+long long Benchmark::perft(Board &board, int depth)
+{
+    MoveList moves;
+    board.generateMoves(moves, ALL_MOVES);
+    if (depth == 1)
+    {
+        return moves.size();
+    }
+
+    long long nodes = 0;
+    for (int i = 0; i < moves.size(); i++)
+    {
+        board.applyMove(moves[i]);
+        nodes += perft(board, depth - 1);
+        board.undoMove(moves[i]);
+    }
+    return nodes;
+}
+
+// Checks the move generator against the known leaf counts of each position, to the depth or to the
+// deepest count known for the position if that is less, and returns whether every count matched
+bool Benchmark::runPerft(int depth, std::ostream &out)
+{
+    int passed = 0;
+    int checked = 0;
+    for (int i = 0; i < numberOfPerftPositions; i++)
+    {
+        int positionDepth = std::min(depth, MAX_PERFT_DEPTH);
+        while ((positionDepth > 0) && (perftPositions[i].counts[positionDepth - 1] == 0))
+        {
+            positionDepth--;
+        }
+        if (positionDepth == 0)
+        {
+            continue;
+        }
+
+        Board board = Board();
+        board.loadFromFEN(perftPositions[i].fen);
+        auto start = std::chrono::high_resolution_clock::now();
+        long long nodes = perft(board, positionDepth);
+        auto stop = std::chrono::high_resolution_clock::now();
+        long long expected = perftPositions[i].counts[positionDepth - 1];
+        checked++;
+        if (nodes == expected)
+        {
+            passed++;
+        }
+
+        out << perftPositions[i].fen << " depth " << positionDepth << ": " << nodes << " nodes, expected "
+            << expected << ((nodes == expected) ? " ok, " : " FAILED, ")
+            << std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count() << " ms\n";
+    }
+
+    out << passed << "/" << checked << " perft counts matched\n";
+    return (passed == checked);
+}
+
+void Benchmark::runTacticalCheck(int depth, std::ostream &out)
+{
+    int found = countTacticsFound(depth, SearchParameters(), &out);
+    out << found << "/" << numberOfTacticalPositions << " tactics found\n";
+}
+
+// Searches each tactical position to the depth and counts those where the winning move was played,
+// each position is reported on out when it is given
+int Benchmark::countTacticsFound(int depth, const SearchParameters &params, std::ostream *out)
+{
+    int found = 0;
+    for (int i = 0; i < numberOfTacticalPositions; i++)
+    {
+        BenchmarkRun run = searchPosition(tacticalPositions[i].fen, depth, [&](MinimaxEngine &engine) { engine.setSearchParameters(params); });
+        bool isFound = (run.move.getStartSquare() == tacticalPositions[i].startSquare) && (run.move.getEndSquare() == tacticalPositions[i].endSquare);
+        if (isFound == true)
+        {
+            found++;
+        }
+        if (out != nullptr)
+        {
+            *out << tacticalPositions[i].fen << ": " << ((isFound == true) ? "found" : "missed")
+                 << ", score " << run.score << "\n";
+        }
+    }
+    return found;
+}
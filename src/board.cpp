@@ -1,6 +1,8 @@
 #include "board.h"
 #include "attackTables.h"
 #include "move.h"
+#include "score.h"
+#include "zobrist.h"
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -9,6 +11,7 @@
 #include <cmath>
 #include <chrono>
 #include <algorithm>
+#include <cassert>
 
 std::chrono::microseconds Board::totalTimeSpentInPseudo(0);
 std::chrono::microseconds Board::totalTimeSpentInLegal(0);
@@ -49,6 +52,11 @@ void Board::resetBoard()
 
     halfMoveClock = 0;
     fullMoveNumber = 1;
+    rebuildPieceLookups();
+    hash = computeHash();
+    pliesFromNullMove = 0;
+    checkStatus = -1;
+    stateCount = 0;
 }
 
 void Board::loadFromFEN(const std::string &fen)
@@ -147,550 +155,662 @@ void Board::loadFromFEN(const std::string &fen)
     halfMoveClock = halfMoveInt;
     int fullMoveInt = std::stoi(fullMove);
     fullMoveNumber = fullMoveInt;
+    rebuildPieceLookups();
+    hash = computeHash();
+    pliesFromNullMove = 0;
+    checkStatus = -1;
+    stateCount = 0;
 }
 
-bool compareMoves(const Move &a, const Move &b)
+void Board::generateLegalMoves(MoveList &legalMoves) const
 {
-    return (a.getScore() > b.getScore());
-}
-
-std::vector<Move> Board::generateLegalMoves()
-{
-    std::vector<Move> legalMoves;
-    std::vector<Move> pseudoLegalMoves;
-    pseudoLegalMoves = generatePseudoLegalMoves();
-
-    int kingColour = turn;
-    std::array<bool, 4> prevCastlingRights = {castlingRights[0], castlingRights[1], castlingRights[2], castlingRights[3]};
-    int prevEnPassantSquare = enPassantSquare;
-    int prevHalfMoveClock = halfMoveClock;
-
     // auto start = std::chrono::high_resolution_clock::now();
-    // Board board = *this;
-    for (int i = 0; i < pseudoLegalMoves.size(); i++)
-    {
+    generateMoves(legalMoves, ALL_MOVES);
 
-        applyMove(pseudoLegalMoves[i]);
-        if (determineIfKingIsInCheck(kingColour, -1) != 1)
-        {
-            legalMoves.push_back(pseudoLegalMoves[i]);
-        }
-        undoMove(pseudoLegalMoves[i], prevCastlingRights, prevEnPassantSquare, prevHalfMoveClock);
+    // Score the moves so that the most promising ones are searched first
+    for (int i = 0; i < legalMoves.size(); i++)
+    {
+        legalMoves.setScore(i, scoreMove(legalMoves[i]));
     }
-
-    std::sort(legalMoves.begin(), legalMoves.end(), compareMoves);
+    legalMoves.sortByScore();
 
     // auto stop = std::chrono::high_resolution_clock::now();
     // auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
     // totalTimeSpentInLegal += duration;
-
-    return legalMoves;
 }
 
-std::vector<Move> Board::generatePseudoLegalMoves() const
+void Board::generateMoves(MoveList &moves, GenerationType type) const
 {
-    // auto start = std::chrono::high_resolution_clock::now();
-    std::vector<Move> pseudoLegalMoves;
-    int index = turn * 6;
+    moves.clear();
+    generateMovesFrom(moves, type, ~0ULL);
+}
 
-    // Also determine the friendly pieces bitboard and the enemy pieces bitboard
-    U64 friendlyPieces = 0ULL;
-    U64 enemyPieces = 0ULL;
-    U64 allPieces;
-    for (int i = 0; i < 6; i++)
+// Legal captures and promotions for the quiescence search, scored but left unsorted
+// because the search usually cuts off after looking at only a few of them
+void Board::generateCaptures(MoveList &captures) const
+{
+    generateMoves(captures, CAPTURES);
+    for (int i = 0; i < captures.size(); i++)
     {
-        friendlyPieces = (index == 0) ? (friendlyPieces | bitboards[i]) : (friendlyPieces | bitboards[i + 6]);
-        enemyPieces = (index == 0) ? (enemyPieces | bitboards[i + 6]) : enemyPieces = (enemyPieces | bitboards[i]);
+        captures.setScore(i, scoreMove(captures[i]));
     }
-    allPieces = friendlyPieces | enemyPieces;
+}
 
-    generatePawnPseudoLegalMoves(pseudoLegalMoves, allPieces, friendlyPieces, enemyPieces);
-    index++;
+// Whether the side to move has a legal move, generating the moves of one kind of piece at a time and
+// stopping at the first kind which has one. The king goes first since in most positions it can move.
+// The checkers and the pinned pieces are found once and shared by every kind of piece.
+bool Board::hasAnyLegalMove() const
+{
+    MoveList moves;
+    int index = turn * 6;
+    int enemyColour = (turn == 0) ? 1 : 0;
+    int kingPosition = get_LSB(bitboards[index + 5]);
+    U64 checkers = determineCheckers();
+    U64 pinned = determinePinnedPieces(kingPosition, occupancy[turn], occupancy[enemyColour]);
 
-    // Generate all of the pseudo legal knight moves
-    U64 knights = bitboards[index];
-    int knightPosition = pop_LSB(knights);
-    while (knightPosition != -1)
+    generateMovesFrom(moves, ALL_MOVES, bitboards[index + 5], checkers, pinned);
+    if ((moves.empty() == false) || ((checkers & (checkers - 1)) != 0))
     {
-        U64 knightAttacks = 0ULL;
-        knightAttacks = attackTables::getKnightAttacks(knightPosition);
-
-        for (int i = 0; i < 64; i++)
+        return (moves.empty() == false);
+    }
+    for (int piece = index; piece < index + 5; piece++)
+    {
+        if (bitboards[piece] != 0)
         {
-            U64 shift = (1ULL << i);
-            if (((knightAttacks & shift) != 0) && ((friendlyPieces & shift) == 0))
+            generateMovesFrom(moves, ALL_MOVES, bitboards[piece], checkers, pinned);
+            if (moves.empty() == false)
             {
-                int capturedPiece = 12;
-                if ((enemyPieces & shift) != 0)
-                {
-                    std::string pieceType = getPieceAt(i);
-                    char pieceTypeCharacter = pieceType[0];
-                    capturedPiece = charToPieceIndex(pieceTypeCharacter);
-                }
-                Move move = Move(knightPosition, i, index, capturedPiece, 12, false, false);
-                move.setMoveScore();
-                pseudoLegalMoves.push_back(move);
+                return true;
             }
         }
-        knightPosition = pop_LSB(knights);
     }
-    index++;
+    return false;
+}
 
-    // auto start1 = std::chrono::high_resolution_clock::now();
-    // Generate all of the pseudo legal bishop moves
-    U64 bishops = bitboards[index];
-    int bishopPosition = pop_LSB(bishops);
-    while (bishopPosition != -1)
+bool Board::isLegalMove(const Move &move) const
+{
+    int startSquare = move.getStartSquare();
+    if ((move.isNull() == true) || (mailbox[startSquare] == 12) || ((mailbox[startSquare] / 6) != turn))
     {
-        U64 bishopAttacks = attackTables::getBishopAttacks(bishopPosition, allPieces);
-        for (int i = 0; i < 64; i++)
-        {
-            U64 shift = 1ULL << i;
-            if (((bishopAttacks & shift) != 0) && ((friendlyPieces & shift) == 0))
-            {
-                int capturedPiece = 12;
-                if ((enemyPieces & shift) != 0)
-                {
-                    std::string pieceType = getPieceAt(i);
-                    char pieceTypeCharacter = pieceType[0];
-                    capturedPiece = charToPieceIndex(pieceTypeCharacter);
-                }
+        return false;
+    }
 
-                Move move = Move(bishopPosition, i, index, capturedPiece, 12, false, false);
-                move.setMoveScore();
-                pseudoLegalMoves.push_back(move);
-            }
+    // Only the moves of the piece on the start square need to be generated
+    MoveList moves;
+    U64 fromMask = 0ULL;
+    set_bit(fromMask, startSquare);
+    generateMovesFrom(moves, ALL_MOVES, fromMask);
+    for (int i = 0; i < moves.size(); i++)
+    {
+        if (moves[i] == move)
+        {
+            return true;
         }
-        bishopPosition = pop_LSB(bishops);
     }
-    index++;
-    // auto stop1 = std::chrono::high_resolution_clock::now();
-    // auto duration1 = std::chrono::duration_cast<std::chrono::microseconds>(stop1 - start1);
-    // totalTimeSpentInOther += duration1;
+    return false;
+}
+
+// Generates the legal moves of the given type for the pieces on the squares in fromMask
+void Board::generateMovesFrom(MoveList &legalMoves, GenerationType type, U64 fromMask) const
+{
+    // The checkers and the pinned pieces are determined once for the position
+    int enemyColour = (turn == 0) ? 1 : 0;
+    int kingPosition = get_LSB(bitboards[turn * 6 + 5]);
+    U64 checkers = determineCheckers();
+    U64 pinned = determinePinnedPieces(kingPosition, occupancy[turn], occupancy[enemyColour]);
+    generateMovesFrom(legalMoves, type, fromMask, checkers, pinned);
+}
+
+// The enemy pieces giving check to the side to move
+U64 Board::determineCheckers() const
+{
+    int enemyColour = (turn == 0) ? 1 : 0;
+    int kingPosition = get_LSB(bitboards[turn * 6 + 5]);
+    return attackersTo(kingPosition, occupancy[2]) & occupancy[enemyColour];
+}
 
-    // Generate all of the pseudo legal rook moves
-    U64 rooks = bitboards[index];
-    int rookPosition = pop_LSB(rooks);
+// Generates the legal moves with the checkers and the pinned pieces of the position already known
+void Board::generateMovesFrom(MoveList &legalMoves, GenerationType type, U64 fromMask, U64 checkers, U64 pinned) const
+{
+    int index = turn * 6;
+    int enemyColour = (turn == 0) ? 1 : 0;
+
+    U64 friendlyPieces = occupancy[turn];
+    U64 enemyPieces = occupancy[enemyColour];
+    U64 allPieces = occupancy[2];
+    int kingPosition = get_LSB(bitboards[index + 5]);
 
-    while (rookPosition != -1)
+    // Captures only target enemy pieces and quiet moves only target empty squares
+    U64 typeMask = (type == CAPTURES) ? enemyPieces : ((type == QUIET_MOVES) ? ~allPieces : ~friendlyPieces);
+
+    // King moves are legal if the target is not attacked once the king has left its square
+    U64 kingTargets = (get_bit(fromMask, kingPosition)) ? (attackTables::getKingAttacks(kingPosition) & typeMask) : 0ULL;
+    U64 occupancyWithoutKing = allPieces & ~bitboards[index + 5];
+    while (kingTargets)
     {
-        U64 rookAttacks = attackTables::getRookAttacks(rookPosition, allPieces);
-        for (int i = 0; i < 64; i++)
+        int endSquare = pop_LSB(kingTargets);
+        if (isSquareAttacked(endSquare, enemyColour, occupancyWithoutKing) == false)
         {
-            U64 shift = 1ULL << i;
-            if (((rookAttacks & shift) != 0) && ((friendlyPieces & shift) == 0))
-            {
-                int capturedPiece = 12;
-                if ((enemyPieces & shift) != 0)
-                {
-                    std::string pieceType = getPieceAt(i);
-                    char pieceTypeCharacter = pieceType[0];
-                    capturedPiece = charToPieceIndex(pieceTypeCharacter);
-                }
-
-                Move move = Move(rookPosition, i, index, capturedPiece, 12, false, false);
-                move.setMoveScore();
-                pseudoLegalMoves.push_back(move);
-            }
+            legalMoves.addMove(Move(kingPosition, endSquare));
         }
-        rookPosition = pop_LSB(rooks);
     }
-    index++;
 
-    // Generate all the of the pseudo legal queen moves
-    U64 queen = bitboards[index];
-    int queenPosition = pop_LSB(queen);
-
-    if (queenPosition != -1)
+    // In double check only the king can move
+    if ((checkers & (checkers - 1)) == 0)
     {
-        U64 queenAttacks = attackTables::getQueenAttacks(queenPosition, allPieces);
+        // Any other move has to capture the checking piece or block the check
+        U64 checkMask = ~0ULL;
+        if (checkers)
+        {
+            int checkerPosition = get_LSB(checkers);
+            checkMask = attackTables::getBetween(kingPosition, checkerPosition) | checkers;
+        }
+        U64 targetMask = typeMask & checkMask;
 
-        for (int i = 0; i < 64; i++)
+        generatePawnMoves(legalMoves, type, fromMask, allPieces, enemyPieces, checkMask, pinned, kingPosition);
+        index++;
+
+        // Generate all of the knight moves, a pinned knight can never move
+        U64 knights = bitboards[index] & fromMask & ~pinned;
+        while (knights)
         {
-            U64 shift = 1ULL << i;
-            if (((queenAttacks & shift) != 0) && ((friendlyPieces & shift) == 0))
-            {
-                int capturedPiece = 12;
-                if ((enemyPieces & shift) != 0)
-                {
-                    std::string pieceType = getPieceAt(i);
-                    char pieceTypeCharacter = pieceType[0];
-                    capturedPiece = charToPieceIndex(pieceTypeCharacter);
-                }
-                Move move = Move(queenPosition, i, index, capturedPiece, 12, false, false);
-                move.setMoveScore();
-                pseudoLegalMoves.push_back(move);
-            }
+            int knightPosition = pop_LSB(knights);
+            U64 knightAttacks = attackTables::getKnightAttacks(knightPosition);
+            addPieceMoves(legalMoves, knightPosition, knightAttacks & targetMask, enemyPieces);
         }
-    }
-    index++;
+        index++;
 
-    // Generate all of the king moves
-    U64 king = bitboards[index];
-    int kingPosition = pop_LSB(king);
-    U64 kingAttacks = attackTables::getKingAttacks(kingPosition);
+        // Generate all of the bishop moves, pinned pieces can only move along the pin
+        U64 bishops = bitboards[index] & fromMask;
+        while (bishops)
+        {
+            int bishopPosition = pop_LSB(bishops);
+            U64 bishopAttacks = attackTables::getBishopAttacks(bishopPosition, allPieces) & targetMask;
+            bishopAttacks &= pinRay(bishopPosition, pinned, kingPosition);
+            addPieceMoves(legalMoves, bishopPosition, bishopAttacks, enemyPieces);
+        }
+        index++;
 
-    for (int i = 0; i < 64; i++)
-    {
-        U64 shift = 1ULL << i;
-        if (((shift & kingAttacks) != 0) && ((shift & friendlyPieces) == 0))
+        // Generate all of the rook moves
+        U64 rooks = bitboards[index] & fromMask;
+        while (rooks)
         {
-            int capturedPiece = 12;
-            if ((enemyPieces & shift) != 0)
-            {
-                std::string pieceType = getPieceAt(i);
-                char pieceTypeCharacter = pieceType[0];
-                capturedPiece = charToPieceIndex(pieceTypeCharacter);
-            }
-            Move move = Move(kingPosition, i, index, capturedPiece, 12, false, false);
-            move.setMoveScore();
-            pseudoLegalMoves.push_back(move);
+            int rookPosition = pop_LSB(rooks);
+            U64 rookAttacks = attackTables::getRookAttacks(rookPosition, allPieces) & targetMask;
+            rookAttacks &= pinRay(rookPosition, pinned, kingPosition);
+            addPieceMoves(legalMoves, rookPosition, rookAttacks, enemyPieces);
+        }
+        index++;
+
+        // Generate all the of the queen moves
+        U64 queens = bitboards[index] & fromMask;
+        while (queens)
+        {
+            int queenPosition = pop_LSB(queens);
+            U64 queenAttacks = attackTables::getQueenAttacks(queenPosition, allPieces) & targetMask;
+            queenAttacks &= pinRay(queenPosition, pinned, kingPosition);
+            addPieceMoves(legalMoves, queenPosition, queenAttacks, enemyPieces);
+        }
+
+        // Castling is only possible when not in check
+        if ((checkers == 0) && (type != CAPTURES) && (get_bit(fromMask, kingPosition)))
+        {
+            generateCastlingMoves(legalMoves, allPieces, kingPosition);
         }
     }
+}
+
+void Board::generateCastlingMoves(MoveList &moves, U64 allPieces, int kingPosition) const
+{
+    int enemyColour = (turn == 0) ? 1 : 0;
 
-    if (index == 5)
+    // The squares between the king and the rook must be empty and the king must not pass over an attacked square
+    if (turn == 0)
     {
-        if ((castlingRights[0]) == true)
+        if ((castlingRights[0] == true) && ((allPieces & 0x0000000000000060ULL) == 0) &&
+            (isSquareAttacked(5, enemyColour, allPieces) == false) && (isSquareAttacked(6, enemyColour, allPieces) == false))
         {
-            U64 piecesBetween = 0ULL;
-            set_bit(piecesBetween, 5);
-            set_bit(piecesBetween, 6);
-            int count = 0;
-            if ((piecesBetween & allPieces) == 0)
-            {
-                for (int i = 4; i < 7; i++)
-                {
-                    bool check = determineIfKingIsInCheck(0, i);
-                    count = count + check;
-                }
-                if (count == 0)
-                {
-                    Move move = Move(kingPosition, 6, index, 12, 12, false, true);
-                    pseudoLegalMoves.push_back(move);
-                }
-            }
+            moves.addMove(Move(kingPosition, 6, CASTLING));
         }
 
-        if (castlingRights[1] == true)
+        if ((castlingRights[1] == true) && ((allPieces & 0x000000000000000EULL) == 0) &&
+            (isSquareAttacked(3, enemyColour, allPieces) == false) && (isSquareAttacked(2, enemyColour, allPieces) == false))
         {
-            U64 piecesBetween = 0ULL;
-            set_bit(piecesBetween, 1);
-            set_bit(piecesBetween, 2);
-            set_bit(piecesBetween, 3);
-            int count = 0;
-            if ((piecesBetween & allPieces) == 0)
-            {
-                for (int i = 2; i < 5; i++)
-                {
-                    bool check = determineIfKingIsInCheck(0, i);
-                    count = count + check;
-                }
-                if (count == 0)
-                {
-                    Move move = Move(kingPosition, 2, index, 12, 12, false, true);
-                    pseudoLegalMoves.push_back(move);
-                }
-            }
+            moves.addMove(Move(kingPosition, 2, CASTLING));
         }
     }
-    else if (index == 11)
+    else
     {
-        if ((castlingRights[2]) == true)
+        if ((castlingRights[2] == true) && ((allPieces & 0x6000000000000000ULL) == 0) &&
+            (isSquareAttacked(61, enemyColour, allPieces) == false) && (isSquareAttacked(62, enemyColour, allPieces) == false))
         {
-            U64 piecesBetween = 0ULL;
-            set_bit(piecesBetween, 61);
-            set_bit(piecesBetween, 62);
-            int count = 0;
-            if ((piecesBetween & allPieces) == 0)
-            {
-                for (int i = 60; i < 63; i++)
-                {
-                    bool check = determineIfKingIsInCheck(1, i);
-                    count = count + check;
-                }
-                if (count == 0)
-                {
-                    Move move = Move(kingPosition, 62, index, 12, 12, false, true);
-                    pseudoLegalMoves.push_back(move);
-                }
-            }
+            moves.addMove(Move(kingPosition, 62, CASTLING));
         }
 
-        if ((castlingRights[3]) == true)
+        if ((castlingRights[3] == true) && ((allPieces & 0x0E00000000000000ULL) == 0) &&
+            (isSquareAttacked(59, enemyColour, allPieces) == false) && (isSquareAttacked(58, enemyColour, allPieces) == false))
         {
-            U64 piecesBetween = 0ULL;
-            set_bit(piecesBetween, 57);
-            set_bit(piecesBetween, 58);
-            set_bit(piecesBetween, 59);
-            int count = 0;
-            if ((piecesBetween & allPieces) == 0)
-            {
-                for (int i = 58; i < 61; i++)
-                {
-                    bool check = determineIfKingIsInCheck(1, i);
-                    count = count + check;
-                }
-                if (count == 0)
-                {
-                    Move move = Move(kingPosition, 58, index, 12, 12, false, true);
-                    pseudoLegalMoves.push_back(move);
-                }
-            }
+            moves.addMove(Move(kingPosition, 58, CASTLING));
         }
     }
-
-    // auto stop = std::chrono::high_resolution_clock::now();
-    // auto duration = std::chrono::duration_cast<std::chrono::microseconds>(stop - start);
-    // totalTimeSpentInPseudo += duration;
-    return pseudoLegalMoves;
 }
 
-void Board::generatePawnPseudoLegalMoves(MoveVec &pawnMoves, U64 allPieces, U64 friendlyPieces, U64 enemyPieces) const
+// Serialises the target squares of a piece, the captures are added before the quiet moves
+void Board::addPieceMoves(MoveList &moves, int startSquare, U64 targets, U64 enemyPieces) const
 {
-    int index = turn * 6;
-    int enemyIndex = (turn == 0) ? 6 : 0;
+    U64 captures = targets & enemyPieces;
+    U64 quietMoves = targets & ~enemyPieces;
 
+    while (captures)
+    {
+        moves.addMove(Move(startSquare, pop_LSB(captures)));
+    }
+
+    while (quietMoves)
+    {
+        moves.addMove(Move(startSquare, pop_LSB(quietMoves)));
+    }
+}
+
+// Pawn moves are generated for all of the pawns at once by shifting the pawn bitboard,
+// the target squares are then serialised and the start square found from the shift
+void Board::generatePawnMoves(MoveList &pawnMoves, GenerationType type, U64 fromMask, U64 allPieces, U64 enemyPieces, U64 checkMask, U64 pinned, int kingPosition) const
+{
     bool isWhite = (turn == 0) ? true : false;
-    U64 startingRank = (isWhite) ? RANK_2 : RANK_7;
+    U64 doublePushRank = (isWhite) ? RANK_4 : RANK_5;
     U64 promotionRank = (isWhite) ? RANK_8 : RANK_1;
-    U64 pawns = bitboards[index];
+    U64 pawns = bitboards[turn * 6] & fromMask;
     U64 emptySquares = ~allPieces;
 
-    while (pawns)
-    {
-        int startSquare = pop_LSB(pawns);
-        U64 pawn = 0ULL;
-        set_bit(pawn, startSquare);
+    U64 singlePushes = ((isWhite) ? north(pawns) : south(pawns)) & emptySquares;
+    U64 doublePushes = ((isWhite) ? north(singlePushes) : south(singlePushes)) & emptySquares & doublePushRank;
 
-        U64 singleMove = 0ULL;
-        U64 doubleMove = 0ULL;
-        singleMove = (isWhite) ? north(pawn) : south(pawn);
-        singleMove = singleMove & emptySquares;
+    // Captures and promotions are generated with the captures, the other pushes are quiet moves
+    if (type != QUIET_MOVES)
+    {
+        U64 westCaptures = ((isWhite) ? north_west(pawns) : south_west(pawns)) & enemyPieces;
+        U64 eastCaptures = ((isWhite) ? north_east(pawns) : south_east(pawns)) & enemyPieces;
+        addPawnMoves(pawnMoves, westCaptures & checkMask, (isWhite) ? 7 : -9, pinned, kingPosition);
+        addPawnMoves(pawnMoves, eastCaptures & checkMask, (isWhite) ? 9 : -7, pinned, kingPosition);
+        addPawnMoves(pawnMoves, singlePushes & promotionRank & checkMask, (isWhite) ? 8 : -8, pinned, kingPosition);
 
-        if (singleMove)
+        if (enPassantSquare != -1)
         {
-            int endSquare = get_LSB(singleMove);
-            if (singleMove & ~promotionRank)
-            {
-                Move move = Move(startSquare, endSquare, index, 12, 12, false, false);
-                move.setMoveScore();
-                pawnMoves.push_back(move);
-            }
-            else
-            {
-                int queen = (isWhite) ? 4 : 10;
-                Move move = Move(startSquare, endSquare, index, 12, queen, false, false);
-                move.setMoveScore();
-                pawnMoves.push_back(move);
-            }
-
-            if (pawn & startingRank)
+            int enemyColour = (isWhite) ? 1 : 0;
+            U64 enPassantPawns = attackTables::getPawnAttacks(enemyColour, enPassantSquare) & pawns;
+            while (enPassantPawns)
             {
-                doubleMove = (isWhite) ? north(singleMove) : south(singleMove);
-                doubleMove = doubleMove & emptySquares;
-
-                if (doubleMove)
+                int startSquare = pop_LSB(enPassantPawns);
+                if (isEnPassantLegal(startSquare, enPassantSquare, allPieces, kingPosition))
                 {
-                    int endSquare = get_LSB(doubleMove);
-                    Move move = Move(startSquare, endSquare, index, 12, 12, false, false);
-                    move.setMoveScore();
-                    pawnMoves.push_back(move);
+                    pawnMoves.addMove(Move(startSquare, enPassantSquare, EN_PASSANT));
                 }
             }
         }
+    }
 
-        U64 leftCapture = 0ULL;
-        leftCapture = (isWhite) ? (north_west(pawn) & ~FILE_H) : (south_east(pawn) & ~FILE_A);
-        leftCapture = leftCapture & enemyPieces;
-        U64 rightCapture = 0ULL;
-        rightCapture = (isWhite) ? (north_east(pawn) & ~FILE_A) : (south_west(pawn) & ~FILE_H);
-        rightCapture = rightCapture & enemyPieces;
-        U64 regularCaptures = leftCapture | rightCapture;
+    if (type != CAPTURES)
+    {
+        addPawnMoves(pawnMoves, singlePushes & ~promotionRank & checkMask, (isWhite) ? 8 : -8, pinned, kingPosition);
+        addPawnMoves(pawnMoves, doublePushes & checkMask, (isWhite) ? 16 : -16, pinned, kingPosition);
+    }
+}
 
-        while (regularCaptures)
+// Serialises pawn target squares which were all reached with the same shift
+void Board::addPawnMoves(MoveList &pawnMoves, U64 targets, int shift, U64 pinned, int kingPosition) const
+{
+    int pieceOffset = turn * 6;
+    U64 promotionRank = (turn == 0) ? RANK_8 : RANK_1;
+
+    while (targets)
+    {
+        int endSquare = pop_LSB(targets);
+        int startSquare = endSquare - shift;
+
+        // A pinned pawn can only move along the line of the pin
+        if ((get_bit(pinned, startSquare)) && (get_bit(attackTables::getLine(kingPosition, startSquare), endSquare) == false))
         {
-            int endSquare = pop_LSB(regularCaptures);
-            U64 capture = 0ULL;
-            set_bit(capture, endSquare);
-            int capturedPiece = getPieceIntAtPosition(endSquare);
-            if (capture & ~promotionRank)
-            {
-                Move move = Move(startSquare, endSquare, index, capturedPiece, 12, false, false);
-                move.setMoveScore();
-                pawnMoves.push_back(move);
-            }
-            else
-            {
-                int queen = (isWhite) ? 4 : 10;
-                Move move = Move(startSquare, endSquare, index, capturedPiece, queen, false, false);
-                move.setMoveScore();
-                pawnMoves.push_back(move);
-            }
+            continue;
         }
 
-        if (enPassantSquare != -1)
+        if (get_bit(promotionRank, endSquare))
         {
-            U64 enPassantRank = (isWhite) ? RANK_5 : RANK_4;
-            if (pawn & enPassantRank)
-            {
-                U64 enPassantBoard = 0ULL;
-                set_bit(enPassantBoard, enPassantSquare);
+            pawnMoves.addMove(Move(startSquare, endSquare, PROMOTION, pieceOffset + 4));
+            pawnMoves.addMove(Move(startSquare, endSquare, PROMOTION, pieceOffset + 1));
+            pawnMoves.addMove(Move(startSquare, endSquare, PROMOTION, pieceOffset + 3));
+            pawnMoves.addMove(Move(startSquare, endSquare, PROMOTION, pieceOffset + 2));
+        }
+        else
+        {
+            pawnMoves.addMove(Move(startSquare, endSquare));
+        }
+    }
+}
 
-                U64 leftCapture = 0ULL;
-                leftCapture = (isWhite) ? (north_west(pawn) & ~FILE_H) : (south_east(pawn) & ~FILE_A);
-                leftCapture = leftCapture & enPassantBoard;
+// En passant removes two pieces from the same rank, so it is checked by looking for
+// attacks on the king with the occupancy after the capture. This also handles the
+// pawn that captures the checking pawn and the discovered checks along the rank.
+bool Board::isEnPassantLegal(int startSquare, int endSquare, U64 allPieces, int kingPosition) const
+{
+    int capturedSquare = (turn == 0) ? (endSquare - 8) : (endSquare + 8);
+    int enemyColour = (turn == 0) ? 1 : 0;
+
+    U64 occupancyAfterCapture = allPieces;
+    clear_bit(occupancyAfterCapture, startSquare);
+    clear_bit(occupancyAfterCapture, capturedSquare);
+    set_bit(occupancyAfterCapture, endSquare);
+
+    U64 attackers = attackersTo(kingPosition, occupancyAfterCapture);
+    U64 enemyPieces = occupancy[enemyColour];
+    clear_bit(enemyPieces, capturedSquare);
+    return (attackers & enemyPieces) == 0;
+}
 
-                if (leftCapture)
-                {
-                    int enemyPawn = (isWhite) ? 6 : 0;
-                    int endSquare = get_LSB(leftCapture);
-                    Move move = Move(startSquare, endSquare, index, enemyPawn, 12, true, false);
-                    move.setMoveScore();
-                    pawnMoves.push_back(move);
-                }
+// A friendly piece is pinned when it is the only piece between the king and an enemy slider
+U64 Board::determinePinnedPieces(int kingPosition, U64 friendlyPieces, U64 enemyPieces) const
+{
+    int enemyIndex = (turn == 0) ? 6 : 0;
+    U64 enemyQueens = bitboards[enemyIndex + 4];
+    U64 snipers = (attackTables::getRookAttacks(kingPosition, enemyPieces) & (bitboards[enemyIndex + 3] | enemyQueens)) |
+                  (attackTables::getBishopAttacks(kingPosition, enemyPieces) & (bitboards[enemyIndex + 2] | enemyQueens));
+    U64 allPieces = friendlyPieces | enemyPieces;
+    U64 pinned = 0ULL;
 
-                U64 rightCapture = 0ULL;
-                rightCapture = (isWhite) ? (north_east(pawn) & ~FILE_A) : (south_west(pawn) & ~FILE_H);
-                rightCapture = rightCapture & enPassantBoard;
+    while (snipers)
+    {
+        int sniperPosition = pop_LSB(snipers);
+        U64 blockers = attackTables::getBetween(kingPosition, sniperPosition) & allPieces;
+        if ((blockers != 0) && ((blockers & (blockers - 1)) == 0))
+        {
+            pinned |= blockers & friendlyPieces;
+        }
+    }
+    return pinned;
+}
 
-                if (rightCapture)
-                {
-                    int enemyPawn = (isWhite) ? 6 : 0;
-                    int endsquare = get_LSB(rightCapture);
-                    Move move = Move(startSquare, endsquare, index, enemyPawn, 12, true, false);
-                    move.setMoveScore();
-                    pawnMoves.push_back(move);
-                }
-            }
+// All of the pieces, of both colours, which attack the given square
+U64 Board::attackersTo(int square, U64 occupancy) const
+{
+    U64 bishopsQueens = bitboards[2] | bitboards[4] | bitboards[8] | bitboards[10];
+    U64 rooksQueens = bitboards[3] | bitboards[4] | bitboards[9] | bitboards[10];
+
+    return (attackTables::getPawnAttacks(1, square) & bitboards[0]) |
+           (attackTables::getPawnAttacks(0, square) & bitboards[6]) |
+           (attackTables::getKnightAttacks(square) & (bitboards[1] | bitboards[7])) |
+           (attackTables::getKingAttacks(square) & (bitboards[5] | bitboards[11])) |
+           (attackTables::getBishopAttacks(square, occupancy) & bishopsQueens) |
+           (attackTables::getRookAttacks(square, occupancy) & rooksQueens);
+}
+
+// Static exchange evaluation, the material the side to move wins or loses if both sides keep
+// capturing on the target square with their least valuable piece and may stop whenever carrying
+// on would lose material. Sliders behind a capturing piece join in once it has moved off the line.
+// Pins are ignored.
+int Board::see(const Move &move) const
+{
+    int startSquare = move.getStartSquare();
+    int endSquare = move.getEndSquare();
+    int capturedPiece = getCapturedPiece(move);
+    int gain[32];
+    int depth = 0;
+
+    U64 occupied = occupancy[2] & ~(1ULL << startSquare);
+    gain[0] = (capturedPiece != 12) ? std::abs(pieceValues[capturedPiece]) : 0;
+    int pieceOnSquareValue = std::abs(pieceValues[mailbox[startSquare]]);
+    if (move.getIsPromotion() == true)
+    {
+        int promotionValue = std::abs(pieceValues[move.getPromotionPiece(turn)]);
+        gain[0] += promotionValue - std::abs(pieceValues[0]);
+        pieceOnSquareValue = promotionValue;
+    }
+    if (move.getIsEnPassant() == true)
+    {
+        occupied &= ~(1ULL << ((turn == 0) ? (endSquare - 8) : (endSquare + 8)));
+    }
+
+    U64 bishopsQueens = bitboards[2] | bitboards[4] | bitboards[8] | bitboards[10];
+    U64 rooksQueens = bitboards[3] | bitboards[4] | bitboards[9] | bitboards[10];
+    U64 attackers = attackersTo(endSquare, occupied) & occupied;
+    int side = (turn == 0) ? 1 : 0;
+
+    while (depth < 31)
+    {
+        U64 sideAttackers = attackers & occupancy[side];
+        if (sideAttackers == 0)
+        {
+            break;
+        }
+
+        // The least valuable attacker recaptures
+        int piece = side * 6;
+        while ((sideAttackers & bitboards[piece]) == 0)
+        {
+            piece++;
+        }
+
+        // The king can only recapture if the square is no longer defended
+        if (((piece % 6) == 5) && ((attackers & occupancy[(side == 0) ? 1 : 0]) != 0))
+        {
+            break;
+        }
+
+        // A capture which loses material whatever follows is not made, and the exchange stops
+        depth++;
+        gain[depth] = pieceOnSquareValue - gain[depth - 1];
+        if (std::max(-gain[depth - 1], gain[depth]) < 0)
+        {
+            depth--;
+            break;
+        }
+
+        occupied &= ~(sideAttackers & bitboards[piece] & -(sideAttackers & bitboards[piece]));
+        if (((piece % 6) == 0) || ((piece % 6) == 2) || ((piece % 6) == 4))
+        {
+            attackers |= attackTables::getBishopAttacks(endSquare, occupied) & bishopsQueens;
+        }
+        if (((piece % 6) == 3) || ((piece % 6) == 4))
+        {
+            attackers |= attackTables::getRookAttacks(endSquare, occupied) & rooksQueens;
         }
+        attackers &= occupied;
+        pieceOnSquareValue = std::abs(pieceValues[piece]);
+        side = (side == 0) ? 1 : 0;
+    }
+
+    // Each side takes the better of stopping and carrying on, working back from the last capture
+    while (depth > 0)
+    {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
     }
+    return gain[0];
 }
 
-bool Board::determineIfKingIsInCheck(int kingColour, int square) const
+bool Board::isSquareAttacked(int square, int attackingColour, U64 occupancy) const
 {
-    U64 blockers = 0ULL;
-    for (int i = 0; i < 12; i++)
+    int index = attackingColour * 6;
+    int defendingColour = (attackingColour == 0) ? 1 : 0;
+
+    if (attackTables::getPawnAttacks(defendingColour, square) & bitboards[index])
+    {
+        return true;
+    }
+    if (attackTables::getKnightAttacks(square) & bitboards[index + 1])
     {
-        blockers |= bitboards[i];
+        return true;
     }
+    if (attackTables::getKingAttacks(square) & bitboards[index + 5])
+    {
+        return true;
+    }
+    U64 queens = bitboards[index + 4];
+    if (attackTables::getBishopAttacks(square, occupancy) & (bitboards[index + 2] | queens))
+    {
+        return true;
+    }
+    if (attackTables::getRookAttacks(square, occupancy) & (bitboards[index + 3] | queens))
+    {
+        return true;
+    }
+    return false;
+}
 
+bool Board::determineIfKingIsInCheck(int kingColour, int square) const
+{
     int kingIndex = (kingColour == 0) ? 5 : 11;
-    int pawnIndex = kingIndex + 1;
-    if (kingColour == 1)
+    int enemyColour = (kingColour == 0) ? 1 : 0;
+
+    // A square can be given to test whether the king would be in check there
+    if (square == -1)
     {
-        pawnIndex = 0;
+        square = get_LSB(bitboards[kingIndex]);
     }
 
-    U64 kingBitboard = bitboards[kingIndex];
-    U64 pawnBitboard = bitboards[pawnIndex];
+    return isSquareAttacked(square, enemyColour, occupancy[2]);
+}
+
+// Whether a legal move checks the enemy king, worked out from the occupancy after the move without
+// making it. The piece which lands gives a direct check, and the sliders behind the squares it left
+// give a discovered check, which for castling includes the rook and for en passant the captured pawn.
+bool Board::givesCheck(const Move &move) const
+{
+    int index = turn * 6;
+    int enemyColour = (turn == 0) ? 1 : 0;
+    int enemyKing = get_LSB(bitboards[(enemyColour * 6) + 5]);
+    int startSquare = move.getStartSquare();
+    int endSquare = move.getEndSquare();
+    int promotionPiece = move.getPromotionPiece(turn);
+    int movedPiece = (promotionPiece != 12) ? promotionPiece : mailbox[startSquare];
+
+    U64 occupancyAfterMove = occupancy[2];
+    clear_bit(occupancyAfterMove, startSquare);
+    set_bit(occupancyAfterMove, endSquare);
+    U64 bishopsQueens = (bitboards[index + 2] | bitboards[index + 4]) & occupancyAfterMove;
+    U64 rooksQueens = (bitboards[index + 3] | bitboards[index + 4]) & occupancyAfterMove;
 
-    if (square != -1)
+    if (move.getIsEnPassant() == true)
     {
-        clear_bit(kingBitboard, get_LSB(kingBitboard));
-        set_bit(kingBitboard, square);
+        clear_bit(occupancyAfterMove, (turn == 0) ? (endSquare - 8) : (endSquare + 8));
+    }
+    else if (move.getIsCastling() == true)
+    {
+        int rookStart = (endSquare > startSquare) ? (startSquare + 3) : (startSquare - 4);
+        int rookEnd = (endSquare > startSquare) ? (startSquare + 1) : (startSquare - 1);
+        clear_bit(occupancyAfterMove, rookStart);
+        set_bit(occupancyAfterMove, rookEnd);
+        clear_bit(rooksQueens, rookStart);
+        set_bit(rooksQueens, rookEnd);
     }
 
-    // Check for pawn attacks
-    U64 pawnAttacks = (kingColour == 0) ? (south_west(pawnBitboard) | south_east(pawnBitboard))
-                                        : (north_west(pawnBitboard) | north_east(pawnBitboard));
-    if (pawnAttacks & kingBitboard)
+    // The moved piece is on its start square in the bitboards, so it counts as a slider only from its end square
+    clear_bit(bishopsQueens, startSquare);
+    clear_bit(rooksQueens, startSquare);
+    int pieceType = movedPiece - index;
+    if ((pieceType == 2) || (pieceType == 4))
     {
-        return true;
+        set_bit(bishopsQueens, endSquare);
+    }
+    if ((pieceType == 3) || (pieceType == 4))
+    {
+        set_bit(rooksQueens, endSquare);
     }
 
-    // Check for knight attacks
-    U64 knightBitboard = bitboards[pawnIndex + 1];
-    while (knightBitboard)
+    if ((pieceType == 0) && (get_bit(attackTables::getPawnAttacks(turn, endSquare), enemyKing)))
     {
-        int knightPos = pop_LSB(knightBitboard);
-        if (attackTables::getKnightAttacks(knightPos) & kingBitboard)
-        {
-            return true;
-        }
+        return true;
+    }
+    if ((pieceType == 1) && (get_bit(attackTables::getKnightAttacks(endSquare), enemyKing)))
+    {
+        return true;
     }
+    return ((attackTables::getBishopAttacks(enemyKing, occupancyAfterMove) & bishopsQueens) != 0) ||
+           ((attackTables::getRookAttacks(enemyKing, occupancyAfterMove) & rooksQueens) != 0);
+}
 
-    // Check for sliding piece attacks (bishops, rooks, and queens)
-    for (int i = 0; i < 3; ++i)
+// The side to move's check status is worked out once per position and kept until a move changes it
+bool Board::isInCheck() const
+{
+    if (checkStatus == -1)
     {
-        U64 pieceBitboard = bitboards[pawnIndex + 2 + i];
-        while (pieceBitboard)
-        {
-            int piecePos = pop_LSB(pieceBitboard);
-            U64 attacks = (i == 0) ? attackTables::getBishopAttacks(piecePos, blockers) : (i == 1) ? attackTables::getRookAttacks(piecePos, blockers)
-                                                                                                   : attackTables::getQueenAttacks(piecePos, blockers);
-            if (attacks & kingBitboard)
-            {
-                return true;
-            }
-        }
+        checkStatus = (determineIfKingIsInCheck(turn, -1) == true) ? 1 : 0;
     }
+    return (checkStatus == 1);
+}
 
-    return false;
+// Squares a piece may move to with respect to pins, pinned pieces can only move along the pin
+U64 Board::pinRay(int square, U64 pinned, int kingPosition) const
+{
+    if (get_bit(pinned, square))
+    {
+        return attackTables::getLine(kingPosition, square);
+    }
+    return ~0ULL;
 }
 
 void Board::applyMove(const Move &move)
 {
     int startSquare = move.getStartSquare();
     int endSquare = move.getEndSquare();
-    int movedPiece = move.getMovedPiece();
-    int capturedPiece = move.getCapturedPiece();
-    int promotionPiece = move.getPromotionPiece();
+    int movedPiece = mailbox[startSquare];
+    int capturedPiece = getCapturedPiece(move);
+    int promotionPiece = move.getPromotionPiece(turn);
     bool isEnPassant = move.getIsEnPassant();
     bool isCastling = move.getIsCastling();
+
+    // Save what the move destroys so that undoMove can restore it
+    StateInfo &state = pushState();
+    state.hash = hash;
+    state.capturedPiece = capturedPiece;
+    state.enPassantSquare = enPassantSquare;
+    state.halfMoveClock = halfMoveClock;
+    state.pliesFromNullMove = pliesFromNullMove;
+    state.checkStatus = checkStatus;
+    std::copy(castlingRights, castlingRights + 4, state.castlingRights);
+
+    // The castling and en passant keys are removed here and the new ones added once the move is made
+    hash ^= castlingAndEnPassantHash();
     enPassantSquare = -1;
 
-    clear_bit(bitboards[movedPiece], startSquare);
-    set_bit(bitboards[movedPiece], endSquare);
-    if ((capturedPiece != 12))
+    if (isEnPassant == true)
     {
-        clear_bit(bitboards[capturedPiece], endSquare);
+        int capturedSquare = (movedPiece == 0) ? (endSquare - 8) : (endSquare + 8);
+        removePiece(capturedPiece, capturedSquare);
     }
+    else if (capturedPiece != 12)
+    {
+        removePiece(capturedPiece, endSquare);
+    }
+
+    movePiece(movedPiece, startSquare, endSquare);
 
     if (promotionPiece != 12)
     {
-        set_bit(bitboards[promotionPiece], endSquare);
-        clear_bit(bitboards[movedPiece], endSquare);
+        removePiece(movedPiece, endSquare);
+        addPiece(promotionPiece, endSquare);
     }
 
-    else if (((movedPiece == 0) || (movedPiece == 11)) && (abs(startSquare - endSquare) == 16))
+    else if (((movedPiece == 0) || (movedPiece == 6)) && (abs(startSquare - endSquare) == 16))
     {
         enPassantSquare = (movedPiece == 0) ? (startSquare + 8) : (startSquare - 8);
     }
 
-    else if (isEnPassant == true)
-    {
-        if (movedPiece == 0)
-        {
-            clear_bit(bitboards[6], endSquare - 8);
-        }
-        else
-        {
-            clear_bit(bitboards[0], endSquare + 8);
-        }
-    }
     else if (isCastling == true)
     {
         if ((movedPiece == 5) && (endSquare == 6))
-
         {
-            clear_bit(bitboards[3], 7);
-            set_bit(bitboards[3], 5);
+            movePiece(3, 7, 5);
         }
         else if ((movedPiece == 5) && (endSquare == 2))
         {
-            clear_bit(bitboards[3], 0);
-            set_bit(bitboards[3], 3);
+            movePiece(3, 0, 3);
         }
-
         else if ((movedPiece == 11) && (endSquare == 62))
         {
-            clear_bit(bitboards[9], 63);
-            set_bit(bitboards[9], 61);
+            movePiece(9, 63, 61);
         }
         else if ((movedPiece == 11) && (endSquare == 58))
         {
-            clear_bit(bitboards[9], 56);
-            set_bit(bitboards[9], 59);
+            movePiece(9, 56, 59);
         }
     }
 
@@ -705,19 +825,20 @@ void Board::applyMove(const Move &move)
         castlingRights[3] = false;
     }
 
-    if ((movedPiece == 3) && (startSquare == 7))
+    // A rook leaving or being captured on its starting square removes the matching castling right
+    if ((startSquare == 7) || (endSquare == 7))
     {
         castlingRights[0] = false;
     }
-    else if ((movedPiece == 3) && (startSquare == 0))
+    if ((startSquare == 0) || (endSquare == 0))
     {
         castlingRights[1] = false;
     }
-    else if ((movedPiece == 3) && (startSquare == 0))
+    if ((startSquare == 63) || (endSquare == 63))
     {
         castlingRights[2] = false;
     }
-    else if ((movedPiece == 3) && (startSquare == 0))
+    if ((startSquare == 56) || (endSquare == 56))
     {
         castlingRights[3] = false;
     }
@@ -732,74 +853,202 @@ void Board::applyMove(const Move &move)
         turn = 0;
     }
     halfMoveClock = ((capturedPiece != 12) || (movedPiece == 6) || (movedPiece == 0)) ? 0 : (halfMoveClock + 1);
+    pliesFromNullMove++;
+    checkStatus = -1;
+    hash ^= castlingAndEnPassantHash() ^ Zobrist::getSideKey();
+    assert(pieceLookupsMatchBitboards());
+    assert(hash == computeHash());
+}
+
+// Whether the position has been seen before with the same side to move. Only positions since the last
+// capture or pawn move can match, so the scan goes back no further than the halfmove clock.
+bool Board::isRepetition() const
+{
+    int distance = std::min(std::min(halfMoveClock, pliesFromNullMove), stateCount);
+    for (int i = 4; i <= distance; i += 2)
+    {
+        if (stateStack[stateCount - i].hash == hash)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Takes the next entry of the state stack. A full stack first drops its oldest entries, the moves
+// they belong to can no longer be undone, undoMove refuses them, but they are too old to matter to
+// the repetition check.
+StateInfo &Board::pushState()
+{
+    if (stateCount == MAX_GAME_PLY)
+    {
+        std::copy(stateStack + (MAX_GAME_PLY - STATE_STACK_KEPT), stateStack + MAX_GAME_PLY, stateStack);
+        stateCount = STATE_STACK_KEPT;
+    }
+    return stateStack[stateCount++];
+}
+
+// A draw by repetition or by the fifty move rule, unless the move which reached a hundred plies gave mate
+bool Board::isDraw() const
+{
+    if (halfMoveClock >= 100)
+    {
+        return (isInCheck() == false) || (hasAnyLegalMove() == true);
+    }
+    return isRepetition();
 }
 
-void Board::undoMove(const Move &move, const std::array<bool, 4> &prevCastlingRights, int prevEnPassantSquare, int prevHalfMoveClock)
+// Passes the turn to the other side without moving, used by the search to test whether a
+// position is so good that even giving the opponent a free move does not spoil it
+void Board::makeNullMove()
 {
+    StateInfo &state = pushState();
+    state.hash = hash;
+    state.capturedPiece = 12;
+    state.enPassantSquare = enPassantSquare;
+    state.halfMoveClock = halfMoveClock;
+    state.pliesFromNullMove = pliesFromNullMove;
+    state.checkStatus = checkStatus;
+    std::copy(castlingRights, castlingRights + 4, state.castlingRights);
+
+    hash ^= castlingAndEnPassantHash();
+    enPassantSquare = -1;
+    hash ^= castlingAndEnPassantHash() ^ Zobrist::getSideKey();
+    halfMoveClock++;
+    pliesFromNullMove = 0;
+    checkStatus = -1;
+    turn = (turn == 0) ? 1 : 0;
+    assert(hash == computeHash());
+}
+
+bool Board::undoNullMove()
+{
+    if (stateCount == 0)
+    {
+        return false;
+    }
+    const StateInfo &state = stateStack[--stateCount];
+    enPassantSquare = state.enPassantSquare;
+    halfMoveClock = state.halfMoveClock;
+    pliesFromNullMove = state.pliesFromNullMove;
+    checkStatus = state.checkStatus;
+    hash = state.hash;
+    turn = (turn == 0) ? 1 : 0;
+    return true;
+}
+
+bool Board::undoMove(const Move &move)
+{
+    if (stateCount == 0)
+    {
+        return false;
+    }
+    const StateInfo &state = stateStack[--stateCount];
+    int capturedPiece = state.capturedPiece;
     int startSquare = move.getStartSquare();
     int endSquare = move.getEndSquare();
-    int movedPiece = move.getMovedPiece();
-    int capturedPiece = move.getCapturedPiece();
-    int promotionPiece = move.getPromotionPiece();
     bool isEnPassant = move.getIsEnPassant();
     bool isCastling = move.getIsCastling();
 
-    enPassantSquare = prevEnPassantSquare;
-    std::copy(prevCastlingRights.begin(), prevCastlingRights.end(), castlingRights);
-    halfMoveClock = prevHalfMoveClock;
+    // The side that made the move is the side not currently to play
+    int colour = (turn == 0) ? 1 : 0;
+    int promotionPiece = move.getPromotionPiece(colour);
+    int movedPiece = (promotionPiece != 12) ? (colour * 6) : mailbox[endSquare];
 
-    clear_bit(bitboards[movedPiece], endSquare);
-    set_bit(bitboards[movedPiece], startSquare);
-    if (capturedPiece != 12)
+    enPassantSquare = state.enPassantSquare;
+    std::copy(state.castlingRights, state.castlingRights + 4, castlingRights);
+    halfMoveClock = state.halfMoveClock;
+    pliesFromNullMove = state.pliesFromNullMove;
+    checkStatus = state.checkStatus;
+
+    if (promotionPiece != 12)
     {
-        set_bit(bitboards[capturedPiece], endSquare);
+        removePiece(promotionPiece, endSquare);
+        addPiece(movedPiece, endSquare);
     }
+    movePiece(movedPiece, endSquare, startSquare);
 
-    if (promotionPiece != 12)
+    if (isEnPassant)
     {
-        clear_bit(bitboards[promotionPiece], endSquare);
+        int capturedSquare = (movedPiece == 0) ? (endSquare - 8) : (endSquare + 8);
+        addPiece(capturedPiece, capturedSquare);
     }
-    else if (isEnPassant)
+    else if (capturedPiece != 12)
     {
-        clear_bit(bitboards[capturedPiece], endSquare);
-        if (movedPiece == 0)
-        {
-            set_bit(bitboards[capturedPiece], endSquare - 8);
-        }
-        else
-        {
-            set_bit(bitboards[capturedPiece], endSquare + 8);
-        }
+        addPiece(capturedPiece, endSquare);
     }
-    else if (isCastling)
+
+    if (isCastling)
     {
         if ((movedPiece == 5) && (endSquare == 6))
         {
-            clear_bit(bitboards[3], 5);
-            set_bit(bitboards[3], 7);
+            movePiece(3, 5, 7);
         }
         else if ((movedPiece == 5) && (endSquare == 2))
         {
-            clear_bit(bitboards[3], 3);
-            set_bit(bitboards[3], 0);
+            movePiece(3, 3, 0);
         }
         else if ((movedPiece == 11) && (endSquare == 62))
         {
-            clear_bit(bitboards[9], 61);
-            set_bit(bitboards[9], 63);
+            movePiece(9, 61, 63);
         }
         else if ((movedPiece == 11) && (endSquare == 58))
         {
-            clear_bit(bitboards[9], 59);
-            set_bit(bitboards[9], 56);
+            movePiece(9, 59, 56);
         }
     }
 
-    turn = (turn == 0) ? 1 : 0;
+    turn = colour;
     if (turn == 1)
     {
-        fullMoveNumber++;
+        fullMoveNumber--;
+    }
+    hash = state.hash;
+    assert(pieceLookupsMatchBitboards());
+    assert(hash == computeHash());
+    return true;
+}
+
+int Board::getCapturedPiece(const Move &move) const
+{
+    if (move.getIsEnPassant())
+    {
+        return (turn == 0) ? 6 : 0;
+    }
+    return getPieceIntAtPosition(move.getEndSquare());
+}
+
+// MVV-LVA, captures are ordered by the value of the victim and then by the cheapest attacker.
+// A capture which loses material in the exchange that follows scores below every quiet move,
+// ordered by how much it loses. Taking a piece worth at least the attacker can never lose
+// material, so the exchange is only worked out for captures of cheaper pieces.
+int Board::scoreMove(const Move &move) const
+{
+    int score = 0;
+    int movedPiece = mailbox[move.getStartSquare()];
+    int capturedPiece = getCapturedPiece(move);
+
+    if (capturedPiece != 12)
+    {
+        int victimValue = std::abs(pieceValues[capturedPiece]);
+        int attackerValue = std::abs(pieceValues[movedPiece]);
+        score = (victimValue * 10) - attackerValue;
+        if (victimValue < attackerValue)
+        {
+            int exchange = see(move);
+            if (exchange < 0)
+            {
+                score = exchange - LOSING_CAPTURE_PENALTY;
+            }
+        }
+    }
+
+    if (move.getIsPromotion())
+    {
+        score += std::abs(pieceValues[move.getPromotionPiece(turn)]) * 10;
     }
+
+    return score;
 }
 
 void Board::setBoard(int pieceToPlay)
@@ -824,16 +1073,23 @@ void Board::setBoard(int pieceToPlay)
     }
 
     inputFile.close();
+    rebuildPieceLookups();
+    hash = computeHash();
+    pliesFromNullMove = 0;
+    checkStatus = -1;
+    stateCount = 0;
 }
 
 void Board::setEnPassantSquare(int square)
 {
     enPassantSquare = square;
+    hash = computeHash();
 }
 
 void Board::setCastlingRights(int caslingRight, bool right)
 {
     castlingRights[caslingRight] = right;
+    hash = computeHash();
 }
 
 void Board::printAllInformation(std::ofstream &output) const
@@ -873,7 +1129,7 @@ int Board::positionToIndex(const std::string &position)
         return -1; // Error case, invalid input
     }
 
-    int file = position[0] - 'A'; // Convert file (A-H) to (0-7)
+    int file = std::toupper(position[0]) - 'A'; // Convert file (A-H or a-h) to (0-7)
     int rank = position[1] - '1'; // Convert rank (1-8) to (0-7)
 
     return 8 * rank + file; // Calculate the index
@@ -914,73 +1170,97 @@ int Board::charToPieceIndex(char pieceChar) const
 
 std::string Board::getPieceAt(int pos) const
 {
-    int count = 0;
-    int type = -1;
-    std::string piece = "";
-    while (type == -1 && count < 12)
-    {
-        if (get_bit(bitboards[count], pos) == 1)
-        {
-            type = count;
-        }
-        count++;
-    }
-    switch (type)
-    {
-    case 0:
-        piece = "P";
-        break;
-    case 1:
-        piece = "N";
-        break;
-    case 2:
-        piece = "B";
-        break;
-    case 3:
-        piece = "R";
-        break;
-    case 4:
-        piece = "Q";
-        break;
-    case 5:
-        piece = "K";
-        break;
-    case 6:
-        piece = "p";
-        break;
-    case 7:
-        piece = "n";
-        break;
-    case 8:
-        piece = "b";
-        break;
-    case 9:
-        piece = "r";
-        break;
-    case 10:
-        piece = "q";
-        break;
-    case 11:
-        piece = "k";
-        break;
-    default:
-        piece = "0";
+    static const char pieceCharacters[] = "PNBRQKpnbrqk0";
+    return std::string(1, pieceCharacters[mailbox[pos]]);
+}
+
+// Computes the Zobrist key of the position from scratch
+U64 Board::computeHash() const
+{
+    U64 key = 0ULL;
+    for (int piece = 0; piece < 12; piece++)
+    {
+        U64 pieceBitboard = bitboards[piece];
+        while (pieceBitboard)
+        {
+            key ^= Zobrist::getPieceKey(piece, pop_LSB(pieceBitboard));
+        }
+    }
+    if (turn == 1)
+    {
+        key ^= Zobrist::getSideKey();
     }
-    return piece;
+    return key ^ castlingAndEnPassantHash();
 }
 
-int Board::getPieceIntAtPosition(int pos) const
+U64 Board::castlingAndEnPassantHash() const
 {
-    int count = 0;
-    while ((count != 12))
+    U64 key = 0ULL;
+    for (int i = 0; i < 4; i++)
     {
-        if (get_bit(bitboards[count], pos))
+        if (castlingRights[i])
+        {
+            key ^= Zobrist::getCastlingKey(i);
+        }
+    }
+    if (enPassantSquare != -1)
+    {
+        key ^= Zobrist::getEnPassantKey(enPassantSquare % 8);
+    }
+    return key;
+}
+
+// Rebuilds the mailbox and the occupancy bitboards from the piece bitboards
+void Board::rebuildPieceLookups()
+{
+    std::fill(std::begin(mailbox), std::end(mailbox), 12);
+    std::fill(std::begin(occupancy), std::end(occupancy), 0ULL);
+    for (int piece = 0; piece < 12; piece++)
+    {
+        occupancy[piece / 6] |= bitboards[piece];
+        U64 pieceBitboard = bitboards[piece];
+        while (pieceBitboard)
+        {
+            mailbox[pop_LSB(pieceBitboard)] = piece;
+        }
+    }
+    occupancy[2] = occupancy[0] | occupancy[1];
+}
+
+bool Board::pieceLookupsMatchBitboards() const
+{
+    U64 expectedOccupancy[2] = {0ULL, 0ULL};
+    for (int piece = 0; piece < 12; piece++)
+    {
+        expectedOccupancy[piece / 6] |= bitboards[piece];
+    }
+    if ((occupancy[0] != expectedOccupancy[0]) || (occupancy[1] != expectedOccupancy[1]) ||
+        (occupancy[2] != (expectedOccupancy[0] | expectedOccupancy[1])))
+    {
+        return false;
+    }
+
+    for (int pos = 0; pos < 64; pos++)
+    {
+        int piece = 12;
+        for (int i = 0; i < 12; i++)
+        {
+            if (get_bit(bitboards[i], pos))
+            {
+                // Two pieces on the same square can never match the mailbox
+                if (piece != 12)
+                {
+                    return false;
+                }
+                piece = i;
+            }
+        }
+        if (mailbox[pos] != piece)
         {
-            return count;
+            return false;
         }
-        count++;
     }
-    return 12;
+    return true;
 }
 
 long long Board::getTotalTimeSpentInPseudoFunction()
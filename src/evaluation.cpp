@@ -1,22 +1,19 @@
 #include "evaluation.h"
 #include "move.h"
-#include <vector>
 #include <cmath>
 #include <iostream>
 #include <fstream>
 
-const double Evaluation::pieceValues[12] = {1, 3, 3, 5, 9, 0, -1, -3, -3, -5, -9, 0};
-
 Evaluation::Evaluation(const EvaluationParameters &params) : evalParams(params)
 {
 }
 
-double Evaluation::evaluateBoard(Board &board) const
+// Score in centipawns from white's point of view
+int Evaluation::evaluateBoard(Board &board) const
 {
-
-    std::vector<Move> legalMoves;
-    legalMoves = board.generateLegalMoves();
-    if ((board.getTurn() == 0) && (legalMoves.empty() == 1))
+    // Only a position without a legal move can be mate or stalemate, which is found without generating them all
+    bool noLegalMoves = (board.hasAnyLegalMove() == false);
+    if ((board.getTurn() == 0) && (noLegalMoves == true))
     {
 
         if (board.determineIfKingIsInCheck(0, -1) == true)
@@ -25,34 +22,34 @@ double Evaluation::evaluateBoard(Board &board) const
             std::ofstream output("output.txt", std::ios::app);
             board.printAllInformation(output);
             output.close();
-            return -INFINITY;
+            return -MATE_SCORE;
         }
         else
         {
             return 0;
         }
     }
-    else if ((board.getTurn() == 1) && (legalMoves.empty() == 1))
+    else if ((board.getTurn() == 1) && (noLegalMoves == true))
     {
         if (board.determineIfKingIsInCheck(1, -1) == true)
         {
-            return INFINITY;
+            return MATE_SCORE;
         }
         else
         {
             return 0;
         }
     }
-    double overallScore = 0;
-    double matEvaluation = materialEvaluation(board);
-    overallScore = matEvaluation * evalParams.materialWeight;
+    int overallScore = 0;
+    int matEvaluation = materialEvaluation(board);
+    overallScore = (int)(matEvaluation * evalParams.materialWeight);
     return overallScore;
 }
 
-double Evaluation::materialEvaluation(const Board &board) const
+int Evaluation::materialEvaluation(const Board &board) const
 {
     const U64 *bitboards = board.getBitboards();
-    double materialSum = 0;
+    int materialSum = 0;
     for (int i = 0; i < 12; i++)
     {
         int pieceCount = 0;
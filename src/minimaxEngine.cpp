@@ -1,162 +1,221 @@
-#include <cmath>
-#include <vector>
-#include <string>
-#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 #include "minimaxEngine.h"
 #include "move.h"
 #include "board.h"
-#include "attackTables.h"
 
 MinimaxEngine::MinimaxEngine(int depth)
 {
     engineDepth = depth;
+    searchDepth = 0;
+    multiPV = 1;
+    nodeLimit = 0;
+    stopped = false;
+    ponderResult = Move();
+    setThreadCount(1);
 }
 
-Move MinimaxEngine::findBestMove(Board &board, int depth)
+MinimaxEngine::~MinimaxEngine()
+{
+    stopPondering();
+}
+
+void MinimaxEngine::setMultiPV(int count)
+{
+    stopPondering();
+    multiPV = std::max(1, std::min(count, MAX_MULTI_PV));
+}
+
+void MinimaxEngine::setSearchParameters(const SearchParameters &params)
+{
+    stopPondering();
+    searchParams = params;
+}
+
+void MinimaxEngine::setHashSize(int megabytes)
 {
-    int turn = board.getTurn();
-    std::array<bool, 4> castlingRights = board.getCastlingRights();
-    int enPassantSquare = board.getEnPassantSquare();
-    int halfMoveClock = board.getHalfMoveClock();
-    bool maximizingPlayer = ((board.getTurn()) == 0) ? false : true;
-    double bestValue = (turn == 0) ? -INFINITY : INFINITY;
-    std::vector<Move> legalMoves = board.generateLegalMoves();
+    stopPondering();
+    transpositionTable.resize(megabytes);
+}
 
-    Move bestMove;
+void MinimaxEngine::clearHash()
+{
+    stopPondering();
+    transpositionTable.clear();
+}
 
-    if (legalMoves.empty() == true)
+void MinimaxEngine::setThreadCount(int count)
+{
+    stopPondering();
+    threads.clear();
+    for (int i = 0; i < std::max(1, count); i++)
     {
-        Move move = Move(-1, -1, -1, -1, -1, false, false);
-        return move;
+        threads.push_back(std::unique_ptr<SearchThread>(new SearchThread(i, *this)));
     }
+    bestThread = threads[0].get();
+}
 
-    for (int i = 0; i < legalMoves.size(); i++)
+Move MinimaxEngine::findBestMove(Board &board, int depth)
+{
+    SearchLimits limits;
+    limits.depth = depth;
+    return findBestMove(board, limits);
+}
+
+Move MinimaxEngine::findBestMove(Board &board, const SearchLimits &limits)
+{
+    stopPondering();
+    if (prepareSearch(board, limits) == false)
     {
-        Move move = legalMoves[i];
-        board.applyMove(move);
-        double value = minimax(board, depth - 1, maximizingPlayer, -INFINITY, INFINITY);
-        board.undoMove(move, castlingRights, enPassantSquare, halfMoveClock);
+        return Move();
+    }
+    return runSearch();
+}
 
-        if (turn == 0)
-        {
-            if (value > bestValue)
-            {
-                bestValue = value;
-                bestMove = move;
-            }
-        }
-        else
-        {
-            if (value < bestValue)
-            {
-                bestValue = value;
-                bestMove = move;
-            }
-        }
+// Hands the root position to every thread and starts the clock, returns false when there is no legal move to search
+bool MinimaxEngine::prepareSearch(const Board &board, const SearchLimits &limits)
+{
+    MoveList legalMoves;
+    board.generateLegalMoves(legalMoves);
+    nodeLimit = limits.nodes;
+    searchDepth = limits.depth;
+    stopped = false;
+    timeManager.start(limits, board.getTurn());
+    transpositionTable.newSearch();
+
+    for (auto &thread : threads)
+    {
+        thread->setPosition(board, legalMoves);
     }
-    return bestMove;
+    bestThread = threads[0].get();
+    return (legalMoves.empty() == false);
 }
 
-double MinimaxEngine::minimax(Board &board, int depth, bool maximizingPlayer, double alpha, double beta)
+// Lazy SMP, every thread runs its own iterative deepening search of the root position. The main
+// thread decides when to stop, then the move of the thread which got furthest is played.
+Move MinimaxEngine::runSearch()
 {
-    // Generate a vector containing all of the legal moves
-    std::vector<Move> legalMoves = board.generateLegalMoves();
-    int number = legalMoves.size();
+    int maxDepth = (searchDepth > 0) ? std::min(searchDepth, MAX_SEARCH_DEPTH) : MAX_SEARCH_DEPTH;
+    std::vector<std::thread> helpers;
+    helpers.reserve(threads.size() - 1);
+    for (size_t i = 1; i < threads.size(); i++)
+    {
+        helpers.emplace_back(&SearchThread::iterativeDeepening, threads[i].get(), maxDepth);
+    }
 
-    // Save the state information of the board
-    std::array<bool, 4> castlingRights = board.getCastlingRights();
-    int enPassantSquare = board.getEnPassantSquare();
-    int halfMoveClock = board.getHalfMoveClock();
+    threads[0]->iterativeDeepening(maxDepth);
 
-    if ((depth == 0) || (legalMoves.empty() == true))
+    // A ponder search which runs out of depths still has no move to play until the opponent has moved
+    while ((timeManager.isPondering() == true) && (isStopped() == false))
     {
-
-        double val = evaluateBoard(board);
-        return val;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
-
-    if (maximizingPlayer)
+    stop();
+    for (std::thread &helper : helpers)
     {
+        helper.join();
+    }
 
-        double maxVal = -INFINITY;
-        for (int i = 0; i < number; i++)
-        {
-            Move move = legalMoves[i];
-            board.applyMove(move);
-            double value = minimax(board, depth - 1, false, alpha, beta);
-            board.undoMove(move, castlingRights, enPassantSquare, halfMoveClock);
-            maxVal = std::max(maxVal, value);
-            alpha = std::max(alpha, value);
-            if (beta <= alpha)
-            {
-                break;
-            }
-        }
-        return maxVal;
+    bestThread = selectBestThread();
+    return bestThread->getBestMove();
+}
+
+// The reply expected from the opponent, the second move of the principal variation of the last search
+Move MinimaxEngine::getPonderMove() const
+{
+    std::vector<Move> principalVariation = bestThread->getPrincipalVariation();
+    return (principalVariation.size() >= 2) ? principalVariation[1] : Move();
+}
+
+// Starts searching the position after the expected reply on a background thread. The board is the
+// position with the opponent to move and the limits are the ones for the engine's next move.
+bool MinimaxEngine::startPondering(const Board &board, const SearchLimits &limits)
+{
+    stopPondering();
+    ponderResult = Move();
+    Move ponderMove = getPonderMove();
+    if ((ponderMove.isNull() == true) || (board.isLegalMove(ponderMove) == false))
+    {
+        return false;
     }
-    else
+
+    ponderBoard = board;
+    ponderBoard.applyMove(ponderMove);
+    SearchLimits ponderLimits = limits;
+    ponderLimits.ponder = true;
+    if (prepareSearch(ponderBoard, ponderLimits) == false)
     {
-        double minVal = INFINITY;
-        for (int i = 0; i < number; i++)
-        {
-            Move move = legalMoves[i];
-            board.applyMove(move);
-            double value = minimax(board, depth - 1, true, alpha, beta);
-            board.undoMove(move, castlingRights, enPassantSquare, halfMoveClock);
-            minVal = std::min(minVal, value);
-            beta = std::min(beta, value);
-            if (beta <= alpha)
-            {
-                break;
-            }
-        }
-        return minVal;
+        return false;
     }
+
+    ponderThread = std::thread([this]() { ponderResult = runSearch(); });
+    return true;
 }
 
-double MinimaxEngine::evaluateBoard(Board &board)
+// Waits for the ponder search to finish under the clock after a ponderhit and returns its move
+Move MinimaxEngine::finishPondering()
 {
-    double overallScore = 0;
-    MoveVec legalMoves = board.generateLegalMoves();
-
-    if ((board.getTurn() == 0) && (legalMoves.empty() == 1))
+    if (ponderThread.joinable() == true)
     {
-        overallScore = (board.determineIfKingIsInCheck(0, -1)) ? -INFINITY : 0;
-        return overallScore;
+        ponderThread.join();
     }
-    else if ((board.getTurn() == 1) && (legalMoves.empty() == 1))
+    return ponderResult;
+}
+
+// After a ponder miss the search is abandoned. The transposition table and the history are left
+// as they are, since much of what they hold is still useful for the position actually reached.
+void MinimaxEngine::stopPondering()
+{
+    if (ponderThread.joinable() == true)
     {
-        overallScore = (board.determineIfKingIsInCheck(1, -1)) ? INFINITY : 0;
-        return overallScore;
+        stop();
+        ponderThread.join();
     }
+}
 
-    double material = evaluateMaterial(board);
-    overallScore = material;
-    return overallScore;
+// The deepest completed iteration wins, and between threads which reached the same depth the higher score
+const SearchThread *MinimaxEngine::selectBestThread() const
+{
+    const SearchThread *best = threads[0].get();
+    for (const auto &thread : threads)
+    {
+        if (thread->getCompletedDepth() > best->getCompletedDepth())
+        {
+            best = thread.get();
+        }
+        else if ((thread->getCompletedDepth() == best->getCompletedDepth()) && (thread->getBestScore() > best->getBestScore()))
+        {
+            best = thread.get();
+        }
+    }
+    return best;
 }
 
-double MinimaxEngine::evaluateMaterial(const Board &board)
+long long MinimaxEngine::getNodeCount() const
 {
-    const U64 *bitboards = board.getBitboards();
-    double materialSum = 0;
-    for (int i = 0; i < 12; i++)
+    long long nodes = 0;
+    for (const auto &thread : threads)
     {
-        int pieceCount = 0;
-        pieceCount = determineNumberOfSpecificPieces(i, bitboards);
-        materialSum = materialSum + (pieceCount * pieceValues[i]);
+        nodes += thread->getNodeCount();
     }
-    return materialSum;
+    return nodes;
 }
 
-int MinimaxEngine::determineNumberOfSpecificPieces(int index, const U64 *bitboards)
+// Share of the beta cutoffs which were caused by the first move searched
+double MinimaxEngine::getFirstMoveCutoffRate() const
 {
-    U64 pieceBitboard = bitboards[index];
-    int i = 0;
-    int position = pop_LSB(pieceBitboard);
-    while (position != -1)
+    long long cutoffs = 0;
+    long long firstMoveCutoffs = 0;
+    for (const auto &thread : threads)
     {
-        position = pop_LSB(pieceBitboard);
-        i++;
+        cutoffs += thread->getCutoffCount();
+        firstMoveCutoffs += thread->getFirstMoveCutoffCount();
     }
-    return i;
-}
\ No newline at end of file
+    return (cutoffs > 0) ? (double)firstMoveCutoffs / cutoffs : 0.0;
+}
+
+bool MinimaxEngine::limitsReached() const
+{
+    return (timeManager.hardLimitReached() == true) || ((nodeLimit > 0) && (getNodeCount() >= nodeLimit));
+}
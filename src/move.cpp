@@ -1,54 +1,77 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include "move.h"
-#include "minimaxEngine.h"
 
-Move::Move()
+Move::Move(int startSquare, int endSquare, int flag, int promotionPiece)
 {
+    // The promotion piece is given as a bitboard index (knight = 1 ... queen = 4 for white)
+    int promotionType = (flag == PROMOTION) ? ((promotionPiece % 6) - 1) : 0;
+    data = static_cast<uint16_t>(startSquare | (endSquare << 6) | (promotionType << 12) | (flag << 14));
 }
 
-Move::Move(int startSquare, int endSquare, int movedPiece, int capturedPiece, int promotionPiece, bool isEnPassant, bool isCastling, double score)
+int Move::getPromotionPiece(int colour) const
 {
-    this->startSquare = startSquare;
-    this->endSquare = endSquare;
-    this->movedPiece = movedPiece;
-    this->capturedPiece = capturedPiece;
-    this->promotionPiece = promotionPiece;
-    this->isEnPassant = isEnPassant;
-    this->isCastling = isCastling;
-    this->score = score;
+    if (getFlag() != PROMOTION)
+    {
+        return 12;
+    }
+    return (colour * 6) + ((data >> 12) & 0x3) + 1;
 }
 
 std::string Move::printMove() const
 {
     std::ostringstream oss;
-    oss << "Starting Square: " << startSquare
-        << "\nEnd Square: " << endSquare
-        << "\nMoved Piece: " << movedPiece
-        << "\nCaptured Piece: " << capturedPiece
-        << "\nPromotion Piece: " << promotionPiece
-        << "\nEn Passant: " << isEnPassant
-        << "\nCastling: " << isCastling << "\n";
+    oss << "Starting Square: " << getStartSquare()
+        << "\nEnd Square: " << getEndSquare()
+        << "\nPromotion: " << getIsPromotion()
+        << "\nEn Passant: " << getIsEnPassant()
+        << "\nCastling: " << getIsCastling() << "\n";
 
     return oss.str();
 }
 
-void Move::setMoveScore()
+void MoveList::sortByScore()
 {
-    double capture = 0;
+    // Sort an index array so the moves and their scores can be permuted together
+    int order[MAX_MOVES];
+    for (int i = 0; i < count; i++)
+    {
+        order[i] = i;
+    }
+    std::sort(order, order + count, [this](int a, int b)
+              { return (scores[a] > scores[b]); });
 
-    if (capturedPiece != 12)
+    Move sortedMoves[MAX_MOVES];
+    int sortedScores[MAX_MOVES];
+    for (int i = 0; i < count; i++)
     {
-        if (abs(pieceValues[movedPiece]) < abs(pieceValues[capturedPiece]))
-        {
-            capture = abs(pieceValues[movedPiece]) - abs(pieceValues[capturedPiece]);
-        }
-        else if (abs(pieceValues[movedPiece]) == abs(pieceValues[capturedPiece]))
+        sortedMoves[i] = moves[order[i]];
+        sortedScores[i] = scores[order[i]];
+    }
+    std::copy(sortedMoves, sortedMoves + count, moves);
+    std::copy(sortedScores, sortedScores + count, scores);
+}
+
+// Moves the entry at index forward to position front, the entries in between each move back one place
+void MoveList::moveToFront(int index, int front)
+{
+    std::rotate(moves + front, moves + index, moves + index + 1);
+    std::rotate(scores + front, scores + index, scores + index + 1);
+}
+
+// Swaps the highest scoring move from start onwards into position start
+void MoveList::selectBest(int start)
+{
+    int best = start;
+    for (int i = start + 1; i < count; i++)
+    {
+        if (scores[i] > scores[best])
         {
-            capture = 1;
+            best = i;
         }
     }
-
-    score = capture;
+    std::swap(moves[start], moves[best]);
+    std::swap(scores[start], scores[best]);
 }
@@ -0,0 +1,119 @@
+#include "movePicker.h"
+
+MovePicker::MovePicker(const Board &board, const Move &ttMove, const Move &killer1, const Move &killer2, const ButterflyHistory *history) : board(board), history(history)
+{
+    this->ttMove = ttMove;
+    killers[0] = killer1;
+    killers[1] = killer2;
+    stage = TT_MOVE_STAGE;
+    killerIndex = 0;
+    captureIndex = 0;
+    quietIndex = 0;
+}
+
+// Returns the next move to search, or the null move once every legal move has been picked
+Move MovePicker::nextMove()
+{
+    while (true)
+    {
+        switch (stage)
+        {
+        case TT_MOVE_STAGE:
+            stage++;
+            if (board.isLegalMove(ttMove))
+            {
+                return ttMove;
+            }
+            ttMove = Move();
+            break;
+
+        case GENERATE_CAPTURES_STAGE:
+            board.generateCaptures(captures);
+            stage++;
+            break;
+
+        case GOOD_CAPTURES_STAGE:
+            // Captures are selected one at a time, the losing ones are left until after the quiet moves
+            while (captureIndex < captures.size())
+            {
+                captures.selectBest(captureIndex);
+                if (captures.getScore(captureIndex) < 0)
+                {
+                    break;
+                }
+                Move move = captures[captureIndex++];
+                if (move != ttMove)
+                {
+                    return move;
+                }
+            }
+            stage++;
+            break;
+
+        case KILLER_MOVES_STAGE:
+            while (killerIndex < 2)
+            {
+                Move killer = killers[killerIndex++];
+                if ((killer.isNull() == true) || (killer == ttMove) || ((killerIndex == 2) && (killer == killers[0])))
+                {
+                    continue;
+                }
+                if ((board.isCapture(killer) == false) && (killer.getIsPromotion() == false) && (board.isLegalMove(killer)))
+                {
+                    return killer;
+                }
+            }
+            stage++;
+            break;
+
+        case GENERATE_QUIETS_STAGE:
+            board.generateMoves(quietMoves, QUIET_MOVES);
+            for (int i = 0; i < quietMoves.size(); i++)
+            {
+                int score = 0;
+                if (history != nullptr)
+                {
+                    score = (*history)[board.getTurn()][quietMoves[i].getStartSquare()][quietMoves[i].getEndSquare()];
+                }
+                quietMoves.setScore(i, score);
+            }
+            stage++;
+            break;
+
+        case QUIET_MOVES_STAGE:
+            while (quietIndex < quietMoves.size())
+            {
+                quietMoves.selectBest(quietIndex);
+                Move move = quietMoves[quietIndex++];
+                if (isAlreadyPicked(move) == false)
+                {
+                    return move;
+                }
+            }
+            stage++;
+            break;
+
+        case BAD_CAPTURES_STAGE:
+            while (captureIndex < captures.size())
+            {
+                captures.selectBest(captureIndex);
+                Move move = captures[captureIndex++];
+                if (move != ttMove)
+                {
+                    return move;
+                }
+            }
+            stage++;
+            break;
+
+        default:
+            return Move();
+        }
+    }
+}
+
+// The hash move and the killers are returned before the quiet moves are generated
+bool MovePicker::isAlreadyPicked(const Move &move) const
+{
+    return (move == ttMove) || (move == killers[0]) || (move == killers[1]);
+}
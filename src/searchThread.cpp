@@ -0,0 +1,720 @@
+#include <cmath>
+#include <algorithm>
+#include "searchThread.h"
+#include "minimaxEngine.h"
+#include "movePicker.h"
+
+// Mate scores are stored relative to the node rather than the root, so that an entry
+// found at a different ply still gives the right distance to mate
+static int scoreToTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)
+    {
+        return score + ply;
+    }
+    if (score <= -MATE_BOUND)
+    {
+        return score - ply;
+    }
+    return score;
+}
+
+static int scoreFromTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)
+    {
+        return score - ply;
+    }
+    if (score <= -MATE_BOUND)
+    {
+        return score + ply;
+    }
+    return score;
+}
+
+int SearchThread::REDUCTIONS[64][64];
+
+// The reduction grows with the logarithm of both the depth and the move number, so late moves at
+// high depth are reduced the most
+void SearchThread::initialiseReductions()
+{
+    for (int depth = 0; depth < 64; depth++)
+    {
+        for (int moveNumber = 0; moveNumber < 64; moveNumber++)
+        {
+            if ((depth == 0) || (moveNumber == 0))
+            {
+                REDUCTIONS[depth][moveNumber] = 0;
+                continue;
+            }
+            REDUCTIONS[depth][moveNumber] = (int)(0.75 + (std::log(depth) * std::log(moveNumber) / 2.25));
+        }
+    }
+}
+
+SearchThread::SearchThread(int id, MinimaxEngine &engine) : id(id), engine(engine)
+{
+    nodeCount = 0;
+    cutoffCount = 0;
+    firstMoveCutoffCount = 0;
+    completedDepth = 0;
+    bestScore = 0;
+    bestMove = Move();
+    lineCount = 0;
+    searchedLineCount = 0;
+    std::fill(&killers[0][0], &killers[0][0] + (MAX_PLY * 2), Move());
+    std::fill(&history[0][0][0], &history[0][0][0] + (2 * 64 * 64), 0);
+    std::fill(nullMoveAtPly, nullMoveAtPly + MAX_PLY, false);
+    std::fill(captureSquareAtPly, captureSquareAtPly + MAX_PLY, -1);
+    std::fill(excludedMove, excludedMove + MAX_PLY, Move());
+    rootDepth = 0;
+}
+
+void SearchThread::setPosition(const Board &rootBoard, const MoveList &legalMoves)
+{
+    board = rootBoard;
+    rootMoves = legalMoves;
+    nodeCount = 0;
+    cutoffCount = 0;
+    firstMoveCutoffCount = 0;
+    completedDepth = 0;
+    bestScore = 0;
+    bestMove = (legalMoves.empty() == true) ? Move() : legalMoves[0];
+    lineCount = 0;
+    searchedLineCount = 0;
+    for (RootLine &line : lines)
+    {
+        line.score = 0;
+        line.depth = 0;
+        line.length = 0;
+    }
+
+    // Killers are specific to the position so they are cleared, the history is only decayed
+    // because what was good in the last search is often still good in this one
+    std::fill(&killers[0][0], &killers[0][0] + (MAX_PLY * 2), Move());
+    for (int colour = 0; colour < 2; colour++)
+    {
+        for (int from = 0; from < 64; from++)
+        {
+            for (int to = 0; to < 64; to++)
+            {
+                history[colour][from][to] /= 2;
+            }
+        }
+    }
+}
+
+// Each iteration searches one ply deeper than the last with the previous best moves first.
+// An iteration which was stopped part of the way through is thrown away and the lines of the
+// last completed one are kept.
+void SearchThread::iterativeDeepening(int maxDepth)
+{
+    lineCount = std::min(engine.getMultiPV(), rootMoves.size());
+
+    // Odd helper threads start a ply deeper so the threads spread over neighbouring depths
+    int startDepth = std::min(maxDepth, 1 + (id % 2));
+    for (int depth = startDepth; depth <= maxDepth; depth++)
+    {
+        rootDepth = depth;
+        aspirationSearch(depth);
+        if (engine.isStopped() == false)
+        {
+            for (int i = 0; i < lineCount; i++)
+            {
+                lines[i] = searchedLines[i];
+                lines[i].depth = depth;
+                placeRootMove(lines[i].moves[0], i);
+            }
+            completedDepth = depth;
+            bestScore = lines[0].score;
+            bestMove = lines[0].moves[0];
+        }
+        if (engine.isStopped() == true)
+        {
+            break;
+        }
+
+        if ((id == 0) && (engine.softLimitReached() == true))
+        {
+            break;
+        }
+    }
+}
+
+// The scores usually change little between iterations, so the root is searched with a narrow window
+// from just under the last score of the worst line to just over that of the best line. The window is
+// widened downwards when the worst line falls below it and upwards when the best line rises above it.
+void SearchThread::aspirationSearch(int depth)
+{
+    int delta = ASPIRATION_WINDOW;
+    int alpha = -INFINITE_SCORE;
+    int beta = INFINITE_SCORE;
+    int previousBest = lines[0].score;
+    int previousWorst = lines[lineCount - 1].score;
+    if ((depth >= ASPIRATION_MIN_DEPTH) && (isMateScore(previousBest) == false) && (isMateScore(previousWorst) == false))
+    {
+        alpha = std::max(previousWorst - delta, -INFINITE_SCORE);
+        beta = std::min(previousBest + delta, INFINITE_SCORE);
+    }
+
+    while (true)
+    {
+        searchRoot(depth, alpha, beta);
+        if (engine.isStopped() == true)
+        {
+            return;
+        }
+
+        int best = searchedLines[0].score;
+        int worst = searchedLines[lineCount - 1].score;
+        if ((best >= beta) && (beta < INFINITE_SCORE))
+        {
+            beta = std::min(best + delta, INFINITE_SCORE);
+        }
+        else if ((worst <= alpha) && (alpha > -INFINITE_SCORE))
+        {
+            if (best <= alpha)
+            {
+                beta = (alpha + beta) / 2;
+            }
+            alpha = std::max(worst - delta, -INFINITE_SCORE);
+        }
+        else
+        {
+            return;
+        }
+        delta += delta / 2;
+    }
+}
+
+// Every root move is searched in one pass which keeps the best lineCount lines found so far. Only the
+// first move gets the full window, the others are tested with a null window against the worst line
+// kept, or alpha until enough lines are kept, and searched again when they beat it. The later lines
+// so reuse the work done for the first. With a single line this is a plain principal variation search.
+void SearchThread::searchRoot(int depth, int alpha, int beta)
+{
+    searchedLineCount = 0;
+    for (int i = 0; i < rootMoves.size(); i++)
+    {
+        Move move = rootMoves[i];
+        bool fullWindow = (searchedLineCount == 0);
+        int worstKept = (searchedLineCount < lineCount) ? -INFINITE_SCORE : searchedLines[lineCount - 1].score;
+        captureSquareAtPly[0] = (board.isCapture(move) == true) ? move.getEndSquare() : -1;
+        board.applyMove(move);
+        engine.getTranspositionTable().prefetch(board.getHash());
+        int value = searchChild(depth, 0, std::max(alpha, worstKept), beta, fullWindow, 0);
+        board.undoMove(move);
+        if (engine.isStopped() == true)
+        {
+            break;
+        }
+
+        if ((searchedLineCount < lineCount) || (value > worstKept))
+        {
+            updatePrincipalVariation(0, move);
+            keepSearchedLine(value);
+        }
+        if (value >= beta)
+        {
+            break;
+        }
+    }
+}
+
+// Puts the line in pvTable[0] into its place among the lines kept by searchRoot, dropping the worst
+// line once all the places are taken
+void SearchThread::keepSearchedLine(int score)
+{
+    int position = std::min(searchedLineCount, lineCount - 1);
+    while ((position > 0) && (searchedLines[position - 1].score < score))
+    {
+        searchedLines[position] = searchedLines[position - 1];
+        position--;
+    }
+
+    RootLine &line = searchedLines[position];
+    line.score = score;
+    line.length = pvLength[0];
+    std::copy(pvTable[0], pvTable[0] + pvLength[0], line.moves);
+    searchedLineCount = std::min(searchedLineCount + 1, lineCount);
+}
+
+// Principal variation search. Only the first move is expected to be best, the others are
+// searched with a null window to prove that they are worse, and a move which fails high is
+// searched again with the full window to find its score. A reduced move which fails high is
+// first searched again at full depth.
+int SearchThread::searchChild(int depth, int ply, int alpha, int beta, bool firstMove, int reduction)
+{
+    if (firstMove == true)
+    {
+        return -negamax(depth - 1, ply + 1, -beta, -alpha);
+    }
+
+    int value = -negamax(depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+    if ((reduction > 0) && (value > alpha) && (engine.isStopped() == false))
+    {
+        value = -negamax(depth - 1, ply + 1, -alpha - 1, -alpha);
+    }
+    if ((value > alpha) && (value < beta) && (engine.isStopped() == false))
+    {
+        value = -negamax(depth - 1, ply + 1, -beta, -alpha);
+    }
+    return value;
+}
+
+// Scores are from the point of view of the side to move, so a child's score is negated
+int SearchThread::negamax(int depth, int ply, int alpha, int beta)
+{
+    // A repeated position or one where the fifty move rule applies is a draw whatever is left to search
+    if ((ply > 0) && (board.isDraw() == true))
+    {
+        pvLength[ply] = ply;
+        return DRAW_SCORE;
+    }
+
+    // The horizon is resolved by searching the captures until the position is quiet
+    if ((depth <= 0) || (ply >= MAX_PLY - 1))
+    {
+        return quiescence(ply, alpha, beta);
+    }
+
+    countNode();
+    pvLength[ply] = ply;
+    bool pvNode = ((beta - alpha) > 1);
+    TranspositionTable &transpositionTable = engine.getTranspositionTable();
+
+    // A search for a singular extension leaves out one move, so the node's stored result does not apply to it
+    Move excluded = excludedMove[ply];
+    bool excludedSearch = (excluded.isNull() == false);
+
+    // A stored result which is deep enough can narrow the window or end the search of this node,
+    // otherwise its best move is still searched first. Nodes on the principal variation are always
+    // searched so that the line is not cut short, except below the replies to the root moves when
+    // more than one line is searched, so that each later line reuses what the lines before it stored.
+    TTEntryData ttEntry;
+    Move ttMove = Move();
+    bool ttHit = transpositionTable.probe(board.getHash(), ttEntry);
+    int ttScore = 0;
+    if (ttHit == true)
+    {
+        ttMove = ttEntry.move;
+        ttScore = scoreFromTT(ttEntry.score, ply);
+        if (((pvNode == false) || ((lineCount > 1) && (ply > 1))) && (excludedSearch == false) && (ttEntry.depth >= depth))
+        {
+            if (ttEntry.bound == BOUND_EXACT)
+            {
+                return ttScore;
+            }
+            else if (ttEntry.bound == BOUND_LOWER)
+            {
+                alpha = std::max(alpha, ttScore);
+            }
+            else if (ttEntry.bound == BOUND_UPPER)
+            {
+                beta = std::min(beta, ttScore);
+            }
+            if (alpha >= beta)
+            {
+                return ttScore;
+            }
+        }
+    }
+    int alphaOriginal = alpha;
+    int turn = board.getTurn();
+    bool inCheck = board.isInCheck();
+    int staticEval = (inCheck == true) ? -INFINITE_SCORE : staticEvaluation();
+    const SearchParameters &params = engine.getSearchParameters();
+
+    // Reverse futility pruning, near the leaves a static evaluation which is above beta by more than
+    // the opponent could win back in the remaining plies is taken as the score without searching
+    if ((params.reverseFutilityPruning == true) && (pvNode == false) && (inCheck == false) && (excludedSearch == false) && (depth <= REVERSE_FUTILITY_MAX_DEPTH) &&
+        (isMateScore(beta) == false) && (staticEval - (params.reverseFutilityMargin * depth) >= beta))
+    {
+        return staticEval;
+    }
+
+    // Razoring, when the static evaluation is far below alpha only the captures are likely to
+    // help, so the quiescence search decides and the node is given up if it cannot reach alpha
+    if ((params.razoring == true) && (pvNode == false) && (inCheck == false) && (excludedSearch == false) && (depth <= RAZORING_MAX_DEPTH) &&
+        (staticEval + (params.razoringMargin * depth) <= alpha))
+    {
+        int value = quiescence(ply, alpha, beta);
+        if (value <= alpha)
+        {
+            return value;
+        }
+    }
+
+    // Null move pruning, if passing the turn still leaves a score above beta after a reduced search then
+    // a real move will almost always do so too. It is not tried in check where passing is illegal, or with
+    // only pawns left where having to move can be a disadvantage and passing gives wrong results.
+    if ((pvNode == false) && (inCheck == false) && (excludedSearch == false) && (depth >= NULL_MOVE_MIN_DEPTH) && (ply > 0) &&
+        (nullMoveAtPly[ply - 1] == false) && (board.hasNonPawnMaterial(turn) == true) && (staticEval >= beta))
+    {
+        int reduction = NULL_MOVE_REDUCTION + (depth / 6);
+        nullMoveAtPly[ply] = true;
+        captureSquareAtPly[ply] = -1;
+        board.makeNullMove();
+        int value = -negamax(depth - 1 - reduction, ply + 1, -beta, -beta + 1);
+        board.undoNullMove();
+        nullMoveAtPly[ply] = false;
+        if (engine.isStopped() == true)
+        {
+            return 0;
+        }
+        if (value >= beta)
+        {
+            // A mate found after passing is not trusted
+            return (isMateScore(value) == true) ? beta : value;
+        }
+    }
+
+    // Singular extension, when a reduced search without the stored best move shows every other move
+    // falling clearly short of the move's stored score, the move is the only good one and is extended
+    bool singular = false;
+    if ((params.singularExtensions == true) && (excludedSearch == false) && (depth >= SINGULAR_MIN_DEPTH) && (ply < 2 * rootDepth) &&
+        (ttMove.isNull() == false) && ((ttEntry.bound == BOUND_LOWER) || (ttEntry.bound == BOUND_EXACT)) &&
+        (ttEntry.depth >= depth - SINGULAR_TT_DEPTH_MARGIN) && (isMateScore(ttScore) == false))
+    {
+        int singularBeta = ttScore - (SINGULAR_MARGIN * depth);
+        excludedMove[ply] = ttMove;
+        int value = negamax((depth - 1) / 2, ply, singularBeta - 1, singularBeta);
+        excludedMove[ply] = Move();
+        if (engine.isStopped() == true)
+        {
+            return 0;
+        }
+        singular = (value < singularBeta);
+        pvLength[ply] = ply;
+    }
+
+    // The moves are picked one at a time so that the later stages are never generated after a cutoff
+    MovePicker movePicker = MovePicker(board, ttMove, killers[ply][0], killers[ply][1], &history);
+    Move move = movePicker.nextMove();
+
+    // Futility pruning, when even a margin for the remaining plies cannot lift the static evaluation
+    // to alpha the quiet moves after the first are not searched, unless they give check
+    bool futile = (params.futilityPruning == true) && (pvNode == false) && (inCheck == false) && (excludedSearch == false) && (depth <= FUTILITY_MAX_DEPTH) &&
+                  (isMateScore(alpha) == false) && (staticEval + (params.futilityMargin * depth) <= alpha);
+
+    int bestValue = -INFINITE_SCORE;
+    Move bestMove = move;
+    int movesSearched = 0;
+    Move quietsSearched[64];
+    int quietCount = 0;
+    while (move.isNull() == false)
+    {
+        if (move == excluded)
+        {
+            move = movePicker.nextMove();
+            continue;
+        }
+
+        // A futile quiet move is skipped before it is made, the check test works from the occupancy alone
+        bool isCapture = board.isCapture(move);
+        bool isQuiet = (isCapture == false) && (move.getIsPromotion() == false);
+        if ((futile == true) && (isQuiet == true) && (movesSearched > 0) && (board.givesCheck(move) == false))
+        {
+            move = movePicker.nextMove();
+            continue;
+        }
+        captureSquareAtPly[ply] = (isCapture == true) ? move.getEndSquare() : -1;
+        board.applyMove(move);
+        bool givesCheck = board.isInCheck();
+        transpositionTable.prefetch(board.getHash());
+        movesSearched++;
+
+        // Extensions, forcing moves are searched a ply deeper so that the tactics they start are seen
+        // through. A move is extended by one ply at most, and not at all once the line is twice the
+        // depth of the iteration, so the extensions cannot grow the tree without bound.
+        int extension = 0;
+        if (ply < 2 * rootDepth)
+        {
+            if ((singular == true) && (move == ttMove))
+            {
+                extension = 1;
+            }
+            else if ((params.checkExtensions == true) && (givesCheck == true))
+            {
+                extension = 1;
+            }
+            else if ((params.recaptureExtensions == true) && (pvNode == true) && (isCapture == true) && (move.getEndSquare() == captureSquareAtPly[ply - 1]))
+            {
+                extension = 1;
+            }
+        }
+
+        // Late move reductions, quiet moves late in the ordering are searched less deeply unless
+        // the position is sharp because the side to move is in check or the move gives check
+        int reduction = 0;
+        if ((isQuiet == true) && (depth >= LMR_MIN_DEPTH) && (movesSearched > LMR_FULL_DEPTH_MOVES) && (inCheck == false) &&
+            (givesCheck == false) && (extension == 0) && (excludedSearch == false))
+        {
+            reduction = REDUCTIONS[std::min(depth, 63)][std::min(movesSearched, 63)];
+            if (pvNode == true)
+            {
+                reduction--;
+            }
+            reduction = std::max(0, std::min(reduction, depth - 2));
+        }
+        int value = searchChild(depth + extension, ply, alpha, beta, (movesSearched == 1), reduction);
+        board.undoMove(move);
+        if (engine.isStopped() == true)
+        {
+            return 0;
+        }
+        if (value > bestValue)
+        {
+            bestValue = value;
+            bestMove = move;
+        }
+        if (value > alpha)
+        {
+            alpha = value;
+            updatePrincipalVariation(ply, move);
+        }
+        if (alpha >= beta)
+        {
+            cutoffCount++;
+            if (movesSearched == 1)
+            {
+                firstMoveCutoffCount++;
+            }
+            if (isQuiet == true)
+            {
+                updateQuietHeuristics(move, depth, ply, quietsSearched, quietCount);
+            }
+            break;
+        }
+        if ((isQuiet == true) && (quietCount < 64))
+        {
+            quietsSearched[quietCount++] = move;
+        }
+        move = movePicker.nextMove();
+    }
+
+    // Without a legal move the side to move is either mated or stalemated, but when the only move was
+    // left out for a singular extension search the node simply fails low
+    if (movesSearched == 0)
+    {
+        if (excludedSearch == true)
+        {
+            return alpha;
+        }
+        return (inCheck == true) ? matedIn(ply) : DRAW_SCORE;
+    }
+    if (excludedSearch == false)
+    {
+        storeResult(bestMove, bestValue, depth, ply, alphaOriginal, beta);
+    }
+    return bestValue;
+}
+
+// Searches only captures and promotions. The side to move may stand pat on the static evaluation
+// since it is not forced to capture, unless it is in check when every evasion is searched instead.
+int SearchThread::quiescence(int ply, int alpha, int beta)
+{
+    countNode();
+    pvLength[ply] = ply;
+
+    int turn = board.getTurn();
+    int standPat = (turn == 0) ? evaluateMaterial() : -evaluateMaterial();
+    if (ply >= MAX_PLY - 1)
+    {
+        return standPat;
+    }
+
+    bool inCheck = board.isInCheck();
+    MoveList moves;
+    int bestValue;
+    if (inCheck == true)
+    {
+        board.generateLegalMoves(moves);
+        if (moves.empty() == true)
+        {
+            return matedIn(ply);
+        }
+        bestValue = -INFINITE_SCORE;
+    }
+    else
+    {
+        if (standPat >= beta)
+        {
+            return standPat;
+        }
+        alpha = std::max(alpha, standPat);
+        bestValue = standPat;
+        board.generateCaptures(moves);
+    }
+
+    for (int i = 0; i < moves.size(); i++)
+    {
+        moves.selectBest(i);
+        Move move = moves[i];
+
+        // Captures which lose material in the exchange are scored below zero and picked last,
+        // so once one is reached none of the rest are worth searching
+        if ((inCheck == false) && (moves.getScore(i) < 0))
+        {
+            break;
+        }
+
+        // Delta pruning, a capture which cannot bring the score back to the window even with
+        // a margin for positional gains is not searched. Promotions are always searched.
+        if ((inCheck == false) && (move.getIsPromotion() == false))
+        {
+            int gain = std::abs(pieceValues[board.getCapturedPiece(move)]) + DELTA_MARGIN;
+            if (standPat + gain <= alpha)
+            {
+                continue;
+            }
+        }
+
+        board.applyMove(move);
+        int value = -quiescence(ply + 1, -beta, -alpha);
+        board.undoMove(move);
+        if (engine.isStopped() == true)
+        {
+            return 0;
+        }
+
+        bestValue = std::max(bestValue, value);
+        if (value > alpha)
+        {
+            alpha = value;
+            updatePrincipalVariation(ply, move);
+        }
+        if (alpha >= beta)
+        {
+            break;
+        }
+    }
+    return bestValue;
+}
+
+// The line from this ply is the move followed by the line found below it
+void SearchThread::updatePrincipalVariation(int ply, const Move &move)
+{
+    pvTable[ply][ply] = move;
+    for (int i = ply + 1; i < pvLength[ply + 1]; i++)
+    {
+        pvTable[ply][i] = pvTable[ply + 1][i];
+    }
+    pvLength[ply] = std::max(pvLength[ply + 1], ply + 1);
+}
+
+// A quiet move which caused a cutoff becomes a killer and gains history, the quiet moves
+// searched before it without causing one lose history
+void SearchThread::updateQuietHeuristics(const Move &move, int depth, int ply, const Move *quietsSearched, int quietCount)
+{
+    if (killers[ply][0] != move)
+    {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int bonus = std::min(depth * depth, 1200);
+    updateHistory(move, bonus);
+    for (int i = 0; i < quietCount; i++)
+    {
+        updateHistory(quietsSearched[i], -bonus);
+    }
+}
+
+// History gravity, the closer an entry is to the limit the less a bonus moves it so that
+// entries saturate smoothly and old results fade as new ones come in
+void SearchThread::updateHistory(const Move &move, int bonus)
+{
+    int &entry = history[board.getTurn()][move.getStartSquare()][move.getEndSquare()];
+    entry += bonus - (entry * std::abs(bonus) / HISTORY_MAX);
+}
+
+void SearchThread::countNode()
+{
+    long long nodes = nodeCount.load(std::memory_order_relaxed) + 1;
+    nodeCount.store(nodes, std::memory_order_relaxed);
+
+    // Only the main thread checks the limits, and only every few thousand nodes to keep the clock
+    // out of the search. Depth one is always finished so there is a move to play.
+    if ((id == 0) && ((nodes & 2047) == 0) && (completedDepth > 0) && (engine.limitsReached() == true))
+    {
+        engine.stop();
+    }
+}
+
+std::vector<Move> SearchThread::getPrincipalVariation() const
+{
+    return std::vector<Move>(lines[0].moves, lines[0].moves + lines[0].length);
+}
+
+// The lines which have been searched at least once, best first
+std::vector<SearchLine> SearchThread::getLines() const
+{
+    std::vector<SearchLine> result;
+    for (int i = 0; (i < lineCount) && (lines[i].depth > 0); i++)
+    {
+        result.push_back({lines[i].score, lines[i].depth, std::vector<Move>(lines[i].moves, lines[i].moves + lines[i].length)});
+    }
+    return result;
+}
+
+// Moves a root move to the given position, the moves from there up to where it was each move back one place
+void SearchThread::placeRootMove(const Move &move, int position)
+{
+    for (int i = position; i < rootMoves.size(); i++)
+    {
+        if (rootMoves[i] == move)
+        {
+            rootMoves.moveToFront(i, position);
+            break;
+        }
+    }
+}
+
+// Stores a node's result with the bound it represents for the window it was searched with
+void SearchThread::storeResult(const Move &move, int value, int depth, int ply, int alpha, int beta)
+{
+    int bound = BOUND_EXACT;
+    if (value <= alpha)
+    {
+        bound = BOUND_UPPER;
+    }
+    else if (value >= beta)
+    {
+        bound = BOUND_LOWER;
+    }
+    engine.getTranspositionTable().store(board.getHash(), move, scoreToTT(value, ply), depth, bound);
+}
+
+int SearchThread::staticEvaluation() const
+{
+    int material = evaluateMaterial();
+    return (board.getTurn() == 0) ? material : -material;
+}
+
+// Material balance in centipawns from white's point of view
+int SearchThread::evaluateMaterial() const
+{
+    const U64 *bitboards = board.getBitboards();
+    int materialSum = 0;
+    for (int i = 0; i < 12; i++)
+    {
+        int pieceCount = 0;
+        pieceCount = determineNumberOfSpecificPieces(i, bitboards);
+        materialSum = materialSum + (pieceCount * pieceValues[i]);
+    }
+    return materialSum;
+}
+
+int SearchThread::determineNumberOfSpecificPieces(int index, const U64 *bitboards) const
+{
+    U64 pieceBitboard = bitboards[index];
+    int i = 0;
+    int position = pop_LSB(pieceBitboard);
+    while (position != -1)
+    {
+        position = pop_LSB(pieceBitboard);
+        i++;
+    }
+    return i;
+}
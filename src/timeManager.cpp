@@ -0,0 +1,47 @@
+#include <algorithm>
+#include "timeManager.h"
+
+// Time kept back for the delay between the engine choosing a move and the clock stopping
+const long long MOVE_OVERHEAD = 10;
+
+// Number of moves the remaining time is shared between when the number to the time control is unknown
+const int DEFAULT_MOVES_TO_GO = 30;
+
+void TimeManager::start(const SearchLimits &limits, int colour)
+{
+    startTime = std::chrono::steady_clock::now();
+    pondering.store(limits.ponder, std::memory_order_relaxed);
+    long long time = (colour == 0) ? limits.whiteTime : limits.blackTime;
+    long long increment = (colour == 0) ? limits.whiteIncrement : limits.blackIncrement;
+
+    if (limits.moveTime > 0)
+    {
+        timeLimited = true;
+        softLimit = std::max(1LL, limits.moveTime - MOVE_OVERHEAD);
+        hardLimit = softLimit;
+    }
+    else if (time > 0)
+    {
+        timeLimited = true;
+        int movesToGo = (limits.movesToGo > 0) ? std::min(limits.movesToGo, 50) : DEFAULT_MOVES_TO_GO;
+        long long available = std::max(1LL, time - MOVE_OVERHEAD);
+
+        // An iteration usually takes a few times longer than the one before it, so the hard limit
+        // gives room to finish one that started just before the soft limit without risking the clock
+        softLimit = std::min(available, (available / movesToGo) + (increment * 3 / 4));
+        hardLimit = std::min(available, softLimit * 4);
+        softLimit = std::max(1LL, softLimit);
+    }
+    else
+    {
+        timeLimited = false;
+        softLimit = 0;
+        hardLimit = 0;
+    }
+}
+
+long long TimeManager::getElapsedTime() const
+{
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
+}
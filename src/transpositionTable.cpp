@@ -0,0 +1,101 @@
+#include <climits>
+#include "transpositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+{
+    age = 0;
+    resize(megabytes);
+}
+
+// Reallocates the table with the largest power of two number of buckets that fits in the given size
+void TranspositionTable::resize(size_t megabytes)
+{
+    size_t bucketCount = 1;
+    while ((bucketCount * 2 * sizeof(TTBucket)) <= (megabytes << 20))
+    {
+        bucketCount *= 2;
+    }
+
+    buckets.reset(new TTBucket[bucketCount]);
+    bucketMask = bucketCount - 1;
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (U64 i = 0; i <= bucketMask; i++)
+    {
+        for (TTEntry &entry : buckets[i].entries)
+        {
+            entry.keyXorData.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age = 0;
+}
+
+U64 TranspositionTable::packData(const Move &move, int score, int depth, int bound, int age)
+{
+    uint16_t scoreBits = (uint16_t)(int16_t)score;
+    return (U64)move.getData() | ((U64)scoreBits << 16) | ((U64)(depth & 0xFF) << 32) | ((U64)bound << 40) | ((U64)age << 42);
+}
+
+bool TranspositionTable::probe(U64 key, TTEntryData &entry) const
+{
+    const TTBucket &bucket = buckets[key & bucketMask];
+    for (const TTEntry &slot : bucket.entries)
+    {
+        U64 data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) != key)
+        {
+            continue;
+        }
+
+        entry.move = Move::fromData((uint16_t)data);
+        entry.score = (int16_t)(uint16_t)(data >> 16);
+        entry.depth = dataDepth(data);
+        entry.bound = (data >> 40) & 0x3;
+        return (entry.bound != BOUND_NONE);
+    }
+    return false;
+}
+
+// Stores over the entry for the same position if there is one, otherwise over the entry
+// which is least worth keeping, judged by its depth and how many searches ago it was written
+void TranspositionTable::store(U64 key, const Move &move, int score, int depth, int bound)
+{
+    TTBucket &bucket = buckets[key & bucketMask];
+    TTEntry *replace = nullptr;
+    Move storedMove = move;
+    int lowestWorth = INT_MAX;
+
+    for (TTEntry &slot : bucket.entries)
+    {
+        U64 data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key)
+        {
+            // Keep the old best move rather than losing it to a search that found none
+            if (storedMove.isNull() == true)
+            {
+                storedMove = Move::fromData((uint16_t)data);
+            }
+            replace = &slot;
+            break;
+        }
+
+        int worth = dataDepth(data) - 4 * ((age - dataAge(data)) & 0x3F);
+        if (data == 0)
+        {
+            worth = INT_MIN;
+        }
+        if (worth < lowestWorth)
+        {
+            lowestWorth = worth;
+            replace = &slot;
+        }
+    }
+
+    U64 data = packData(storedMove, score, depth, bound, age);
+    replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
@@ -0,0 +1,40 @@
+#include "zobrist.h"
+
+U64 Zobrist::PIECE_KEYS[12][64];
+U64 Zobrist::SIDE_KEY;
+U64 Zobrist::CASTLING_KEYS[4];
+U64 Zobrist::EN_PASSANT_KEYS[8];
+
+// xorshift64* generator, a fixed seed keeps the keys the same between runs
+static U64 nextRandom(U64 &state)
+{
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+void Zobrist::initialiseKeys()
+{
+    U64 state = 0x9E3779B97F4A7C15ULL;
+
+    for (int piece = 0; piece < 12; piece++)
+    {
+        for (int square = 0; square < 64; square++)
+        {
+            PIECE_KEYS[piece][square] = nextRandom(state);
+        }
+    }
+
+    SIDE_KEY = nextRandom(state);
+
+    for (int i = 0; i < 4; i++)
+    {
+        CASTLING_KEYS[i] = nextRandom(state);
+    }
+
+    for (int file = 0; file < 8; file++)
+    {
+        EN_PASSANT_KEYS[file] = nextRandom(state);
+    }
+}